@@ -12,6 +12,7 @@
 
 #include "mir/action/filter/BitmapFilter.h"
 
+#include <memory>
 #include <ostream>
 #include <sstream>
 
@@ -52,29 +53,30 @@ void BitmapFilter::print(std::ostream& out) const {
 }
 
 
-util::Bitmap& BitmapFilter::bitmap() const {
+std::shared_ptr<util::Bitmap> BitmapFilter::bitmap() const {
     static util::recursive_mutex local_mutex;
     util::lock_guard<util::recursive_mutex> lock(local_mutex);
 
-    auto* j = cache.find(path_);
-    if (j != cache.end()) {
-        return *j;
+    if (auto j = cache.find(path_); j) {
+        return j;
     }
 
-    auto& bitmap = cache.insert(path_, new util::Bitmap(path_));
-    cache.footprint(path_, caching::InMemoryCacheUsage(bitmap.footprint(), 0));
-    return bitmap;
+    std::unique_ptr<util::Bitmap> bitmap(new util::Bitmap(path_));
+    const caching::InMemoryCacheUsage usage(bitmap->footprint(), size_t(0));
+    return cache.insert(path_, bitmap.release(), usage);
 }
 
 
 void BitmapFilter::execute(context::Context& ctx) const {
-
-    // Make sure another thread to no evict anything from the cache while we are using it
-    auto cacheUse(ctx.statistics().cacheUser(cache));
     auto timing(ctx.statistics().bitmapTimer());
 
     auto& field = ctx.field();
-    auto& b     = bitmap();
+
+    // bitmap in use (not purged)
+    const auto handle = bitmap();
+    ctx.statistics().cacheStatistics(cache);
+
+    const auto& b = *handle;
 
     for (size_t f = 0; f < field.dimensions(); f++) {
 
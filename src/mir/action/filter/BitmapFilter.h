@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mir/action/plan/Action.h"
 
 
@@ -79,7 +81,7 @@ private:
 
     // -- Methods
 
-    util::Bitmap& bitmap() const;
+    std::shared_ptr<util::Bitmap> bitmap() const;
 
     // -- Overridden methods
 
@@ -49,6 +49,11 @@ const method::Method& Gridded2GriddedInterpolation::method() const {
 
 
 bool Gridded2GriddedInterpolation::mergeWithNext(const Action& next) {
+    if (next_) {
+        // cropping applies to the fused interpolation output
+        return next_->mergeWithNext(next);
+    }
+
     if (next.canCrop() && method_->canCrop()) {
         method_->setCropping(next.outputBoundingBox());
         return true;
@@ -57,17 +62,30 @@ bool Gridded2GriddedInterpolation::mergeWithNext(const Action& next) {
 }
 
 
-bool Gridded2GriddedInterpolation::canCrop() const {
-    return method_->hasCropping();
+bool Gridded2GriddedInterpolation::fuseWithNext(std::unique_ptr<Action>& next) {
+    // two consecutive interpolations as one (composed) operator, if the methods allow (opt-in, as results differ in
+    // rounding from interpolating in two steps)
+    bool compose = false;
+    parametrisation_.get("interpolation-compose", compose);
+
+    auto* o = dynamic_cast<Gridded2GriddedInterpolation*>(next.get());
+    if (compose && !next_ && o != nullptr && !o->next_ && method_->canCompose(*o->method_)) {
+        next_.reset(o);
+        next.release();
+        return true;
+    }
+
+    return false;
 }
 
 
-method::Cropping Gridded2GriddedInterpolation::cropping(context::Context& ctx) const {
+bool Gridded2GriddedInterpolation::canCrop() const {
+    return method_->hasCropping();
+}
 
-    const data::MIRField& field = ctx.field();
 
-    repres::RepresentationHandle in(field.representation());
-    auto input = in->domain();
+method::Cropping Gridded2GriddedInterpolation::cropping(const repres::Representation& in) const {
+    auto input = in.domain();
     auto output(outputBoundingBox());
 
     method::Cropping crop;
@@ -123,31 +141,54 @@ void Gridded2GriddedInterpolation::execute(context::Context& ctx) const {
     auto& field = ctx.field();
     repres::RepresentationHandle in(field.representation());
 
-    method::Cropping crop = cropping(ctx);
+    method::Cropping crop = cropping(*in);
 
     repres::RepresentationHandle output(outputRepresentation());
     repres::RepresentationHandle out(crop ? output->croppedRepresentation(crop.boundingBox()) : output.operator->());
 
-    method_->execute(ctx, *in, *out);
+    if (!next_) {
+        method_->execute(ctx, *in, *out);
+        field.representation(out);
+        return;
+    }
+
+    // fused interpolation: in one step if possible for this field (composed operator), otherwise in two
+    method::Cropping nextCrop = next_->cropping(*out);
+
+    repres::RepresentationHandle nextOutput(next_->outputRepresentation());
+    repres::RepresentationHandle last(nextCrop ? nextOutput->croppedRepresentation(nextCrop.boundingBox())
+                                               : nextOutput.operator->());
+
+    if (!method_->compose(ctx, *in, *out, *next_->method_, *last)) {
+        method_->execute(ctx, *in, *out);
+        field.representation(out);
 
-    field.representation(out);
+        next_->method_->execute(ctx, *out, *last);
+    }
+
+    field.representation(last);
 }
 
 
 bool Gridded2GriddedInterpolation::sameAs(const Action& other) const {
     const auto* o = dynamic_cast<const Gridded2GriddedInterpolation*>(&other);
     return (o != nullptr) && (interpolation_ == o->interpolation_) && method_->sameAs(*o->method_) &&
-           (inputIntersectsOutput_ == o->inputIntersectsOutput_);
+           (inputIntersectsOutput_ == o->inputIntersectsOutput_) && (!next_ == !o->next_) &&
+           (!next_ || next_->sameAs(*o->next_));
 }
 
 
 void Gridded2GriddedInterpolation::print(std::ostream& out) const {
     out << "interpolation=" << interpolation_ << ",method=" << *method_;
+    if (next_) {
+        out << ",next=" << *next_;
+    }
 }
 
 void Gridded2GriddedInterpolation::estimate(context::Context& ctx, api::MIREstimation& estimation) const {
 
-    method::Cropping crop = cropping(ctx);
+    repres::RepresentationHandle in(ctx.field().representation());
+    method::Cropping crop = cropping(*in);
 
     repres::RepresentationHandle output(outputRepresentation());
     repres::RepresentationHandle out(crop ? output->croppedRepresentation(crop.boundingBox()) : output.operator->());
@@ -156,6 +197,10 @@ void Gridded2GriddedInterpolation::estimate(context::Context& ctx, api::MIREstim
     estimateMissingValues(ctx, estimation, *out);
 
     ctx.field().representation(out);
+
+    if (next_) {
+        next_->estimate(ctx, estimation);
+    }
 }
 
 
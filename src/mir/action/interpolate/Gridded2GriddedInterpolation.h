@@ -88,6 +88,7 @@ private:
 
     std::string interpolation_;
     std::unique_ptr<method::Method> method_;
+    std::unique_ptr<Gridded2GriddedInterpolation> next_;  ///< fused (following) interpolation
     bool inputIntersectsOutput_;
 
     // -- Methods
@@ -98,9 +99,10 @@ private:
 
     void execute(context::Context&) const override;
     bool mergeWithNext(const Action&) override;
+    bool fuseWithNext(std::unique_ptr<Action>&) override;
     bool canCrop() const override;
 
-    method::Cropping cropping(context::Context&) const;
+    method::Cropping cropping(const repres::Representation& in) const;
 
     // -- Class members
     // None
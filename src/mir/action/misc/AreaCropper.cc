@@ -12,8 +12,12 @@
 
 #include "mir/action/misc/AreaCropper.h"
 
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "eckit/utils/MD5.h"
@@ -25,7 +29,7 @@
 #include "mir/data/MIRField.h"
 #include "mir/key/Area.h"
 #include "mir/param/MIRParametrisation.h"
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
@@ -63,10 +67,33 @@ AreaCropper::AreaCropper(const param::MIRParametrisation& parametrisation) :
 }
 
 
+/// Points of the same latitude, consecutive in iteration order
+struct Row {
+    double lat_;
+    size_t begin_;
+    size_t end_;
+};
+
+
+/// Split points into rows of unique latitudes, ordered like natural scanning mode (false if latitudes repeat in
+/// different rows)
+static bool rows(const repres::Coordinates& coord, std::vector<Row>& rows) {
+    rows.clear();
+    for (size_t i = 0, j = 0; i < coord.size(); i = j) {
+        for (j = i + 1; j < coord.size() && coord.latitudes[j] == coord.latitudes[i]; ++j) {
+        }
+        rows.push_back({coord.latitudes[i], i, j});
+    }
+
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.lat_ > b.lat_; });
+
+    return std::adjacent_find(rows.begin(), rows.end(),
+                              [](const Row& a, const Row& b) { return a.lat_ == b.lat_; }) == rows.end();
+}
+
+
 void AreaCropper::crop(const repres::Representation& repres, util::BoundingBox& bbox,
                        util::AreaCropperMapping& mapping) {
-    std::map<LL, size_t> m;
-
     Latitude n  = 0;
     Latitude s  = 0;
     Longitude e = 0;
@@ -74,19 +101,62 @@ void AreaCropper::crop(const repres::Representation& repres, util::BoundingBox&
 
     bool first = true;
 
-    // Iterator is "unrotated", because the cropping area is expressed in before the rotation is applied
-    for (const std::unique_ptr<repres::Iterator> it(repres.iterator()); it->next();) {
-        const auto& point = it->pointUnrotated();
+    // Coordinates are "unrotated", because the cropping area is expressed in before the rotation is applied
+    repres::Coordinates coord;
+    repres.coordinates(coord, false);
+
+    mapping.clear();
+
+    std::vector<Row> r;
+    if (rows(coord, r)) {
+
+        // Rows outside of the latitude range are skipped, others keep the points within the longitude range (in a
+        // contiguous range of row indices, possibly wrapped around) ordered by increasing (normalised) longitude
+        std::vector<std::pair<double, size_t>> row;
+
+        for (const auto& k : r) {
+            const Latitude lat(k.lat_);
+            if (!(lat <= bbox.north() && lat >= bbox.south())) {
+                continue;
+            }
+
+            row.clear();
+            for (size_t i = k.begin_; i < k.end_; ++i) {
+                const Longitude lon = Longitude(coord.longitudes[i]).normalise(bbox.west());
+                if (lon <= bbox.east()) {
+                    row.emplace_back(lon.value(), coord.indices[i]);
+                }
+            }
+
+            if (row.empty()) {
+                continue;
+            }
+
+            auto lon_less = [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+                return a.first < b.first;
+            };
+
+            if (auto mid = std::is_sorted_until(row.begin(), row.end(), lon_less); mid != row.end()) {
+                if (std::is_sorted(mid, row.end(), lon_less) && !lon_less(row.front(), row.back())) {
+                    std::rotate(row.begin(), mid, row.end());
+                }
+                else {
+                    std::sort(row.begin(), row.end(), lon_less);
+                }
+            }
 
-        // Log::debug() << point << " ====> " << bbox.contains(point) << std::endl;
+            // Make sure we don't visit duplicate points
+            ASSERT(std::adjacent_find(row.begin(), row.end(), [](const auto& a, const auto& b) {
+                       return a.first == b.first;
+                   }) == row.end());
 
-        if (bbox.contains(point)) {
-            const Latitude& lat = point.lat();
-            const Longitude lon = point.lon().normalise(bbox.west());
+            const Longitude west(row.front().first);
+            const Longitude east(row.back().first);
 
             if (first) {
                 n = s = lat;
-                e = w = lon;
+                w     = west;
+                e     = east;
                 first = false;
             }
             else {
@@ -96,32 +166,68 @@ void AreaCropper::crop(const repres::Representation& repres, util::BoundingBox&
                 if (s > lat) {
                     s = lat;
                 }
-                if (e < lon) {
-                    e = lon;
+                if (e < east) {
+                    e = east;
                 }
-                if (w > lon) {
-                    w = lon;
+                if (w > west) {
+                    w = west;
                 }
             }
 
-            // Make sure we don't visit duplicate points
-            ASSERT(m.insert(std::make_pair(LL(lat, lon), it->index())).second);
+            for (const auto& j : row) {
+                mapping.push_back(j.second);
+            }
+        }
+    }
+    else {
+
+        std::map<LL, size_t> m;
+
+        for (size_t i = 0; i < coord.size(); ++i) {
+            const auto point = coord.pointLatLon(i);
+
+            if (bbox.contains(point)) {
+                const Latitude& lat = point.lat();
+                const Longitude lon = point.lon().normalise(bbox.west());
+
+                if (first) {
+                    n = s = lat;
+                    e = w = lon;
+                    first = false;
+                }
+                else {
+                    if (n < lat) {
+                        n = lat;
+                    }
+                    if (s > lat) {
+                        s = lat;
+                    }
+                    if (e < lon) {
+                        e = lon;
+                    }
+                    if (w > lon) {
+                        w = lon;
+                    }
+                }
+
+                // Make sure we don't visit duplicate points
+                ASSERT(m.insert(std::make_pair(LL(lat, lon), coord.indices[i])).second);
+            }
+        }
+
+        mapping.reserve(m.size());
+        for (const auto& j : m) {
+            mapping.push_back(j.second);
         }
     }
 
     // Set mapping (don't support empty results)
-    if (m.empty()) {
+    if (mapping.empty()) {
         std::ostringstream oss;
         oss << "Cropping " << repres << " to " << bbox << " returns no points";
         throw exception::UserError(oss.str());
     }
 
-    mapping.clear();
-    mapping.reserve(m.size());
-    for (const auto& j : m) {
-        mapping.push_back(j.second);
-    }
-
     // Set resulting bounding box
     bbox = util::BoundingBox(n, w, s, e);
 }
@@ -162,18 +268,18 @@ static void createCroppingCacheEntry(caching::CroppingCacheEntry& c, const repre
 }
 
 
-static const caching::CroppingCacheEntry& getMapping(const std::string& key,
-                                                     const repres::Representation* representation,
-                                                     const util::BoundingBox& bbox, bool caching) {
+static caching::InMemoryCache<caching::CroppingCacheEntry>::handle_type getMapping(
+    const std::string& key, const repres::Representation* representation, const util::BoundingBox& bbox,
+    bool caching) {
     static util::recursive_mutex local_mutex;
     util::lock_guard<util::recursive_mutex> lock(local_mutex);
 
-    auto a = cache.find(key);
-    if (a != cache.end()) {
-        return *a;
+    if (auto a = cache.find(key); a) {
+        return a;
     }
 
-    auto& c = cache[key];
+    std::unique_ptr<caching::CroppingCacheEntry> entry(new caching::CroppingCacheEntry);
+    auto& c = *entry;
     if (caching) {
         static caching::CroppingCache disk;
 
@@ -205,13 +311,13 @@ static const caching::CroppingCacheEntry& getMapping(const std::string& key,
         createCroppingCacheEntry(c, representation, bbox);
     }
 
-    cache.footprint(key, caching::InMemoryCacheUsage(c.footprint(), 0));
-    return c;
+    const caching::InMemoryCacheUsage usage(c.footprint(), size_t(0));
+    return cache.insert(key, entry.release(), usage);
 }
 
 
-static const caching::CroppingCacheEntry& getMapping(const repres::Representation* representation,
-                                                     const util::BoundingBox& bbox, bool caching) {
+static caching::InMemoryCache<caching::CroppingCacheEntry>::handle_type getMapping(
+    const repres::Representation* representation, const util::BoundingBox& bbox, bool caching) {
     eckit::MD5 md5;
     md5 << representation->uniqueName() << bbox;
 
@@ -231,9 +337,6 @@ static const caching::CroppingCacheEntry& getMapping(const repres::Representatio
 
 
 void AreaCropper::execute(context::Context& ctx) const {
-
-    // Make sure another thread to no evict anything from the cache while we are using it
-    auto cacheUse(ctx.statistics().cacheUser(cache));
     auto timing(ctx.statistics().cropTimer());
 
     // Keep a pointer on the original representation, as the one in the field will
@@ -241,22 +344,35 @@ void AreaCropper::execute(context::Context& ctx) const {
     auto& field = ctx.field();
     repres::RepresentationHandle representation(field.representation());
 
-    const auto& c = getMapping(representation, bbox_, caching_);
+    // entry in use (not purged)
+    const auto entry = getMapping(representation, bbox_, caching_);
+    ctx.statistics().cacheStatistics(cache);
+
+    const auto& c = *entry;
     ASSERT_NONEMPTY_AREA_CROP("AreaCropper", !c.mapping_.empty());
 
+    // Mapping as slices of consecutive indices, [begin, end)
+    std::vector<std::pair<size_t, size_t>> slices;
+    for (size_t k = 0, l = 0; k < c.mapping_.size(); k = l) {
+        for (l = k + 1; l < c.mapping_.size() && c.mapping_[l] == c.mapping_[l - 1] + 1; ++l) {
+        }
+        slices.emplace_back(c.mapping_[k], c.mapping_[k] + (l - k));
+    }
+
+    repres::RepresentationHandle cropped(representation->croppedRepresentation(c.bbox_));
+    // Log::debug() << *cropped << std::endl;
+
     for (size_t i = 0; i < field.dimensions(); i++) {
         const MIRValuesVector& values = field.values(i);
 
         MIRValuesVector result;
         result.reserve(c.mapping_.size());
 
-        for (const auto& j : c.mapping_) {
-            result.push_back(values[j]);
+        for (const auto& slice : slices) {
+            ASSERT(slice.second <= values.size());
+            result.insert(result.end(), values.begin() + slice.first, values.begin() + slice.second);
         }
 
-        repres::RepresentationHandle cropped(representation->croppedRepresentation(c.bbox_));
-        // Log::debug() << *cropped << std::endl;
-
         if (result.empty()) {
             std::ostringstream oss;
             oss << "AreaCropper: failed to crop " << *representation << " with bbox " << c.bbox_
@@ -53,6 +53,11 @@ bool Action::deleteWithNext(const Action& /*unused*/) {
 }
 
 
+bool Action::fuseWithNext(std::unique_ptr<Action>& /*unused*/) {
+    return false;
+}
+
+
 bool Action::isEndAction() const {
     return false;
 }
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 
 
@@ -70,6 +71,7 @@ public:
     // For optimising plans
     virtual bool mergeWithNext(const Action&);
     virtual bool deleteWithNext(const Action&);
+    virtual bool fuseWithNext(std::unique_ptr<Action>&);  // takes ownership if true
     virtual bool isEndAction() const;
     virtual bool isCropAction() const;
     virtual bool canCrop() const;
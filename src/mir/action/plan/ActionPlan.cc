@@ -13,6 +13,7 @@
 #include "mir/action/plan/ActionPlan.h"
 
 #include <fstream>
+#include <memory>
 #include <ostream>
 #include <sstream>
 
@@ -226,6 +227,24 @@ void ActionPlan::compress() {
                 more          = true;
                 break;
             }
+
+            std::unique_ptr<Action> next(at(i + 1));
+            const bool fused = action(i).fuseWithNext(next);
+            at(i + 1)        = next.release();
+
+            if (fused) {
+                ASSERT(at(i + 1) == nullptr);
+
+                Log::debug() << "ActionPlan::compress: "
+                             << "\n   " << oldAction.str() << " (fused)"
+                             << "\n = " << action(i) << std::endl;
+
+                erase(begin() + long(i + 1));
+
+                hasCompressed = true;
+                more          = true;
+                break;
+            }
         }
     }
 
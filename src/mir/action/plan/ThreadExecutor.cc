@@ -12,74 +12,299 @@
 
 #include "mir/action/plan/ThreadExecutor.h"
 
-#include "eckit/thread/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include "eckit/config/Resource.h"
 
 #include "mir/action/context/Context.h"
 #include "mir/action/plan/ActionNode.h"
+#include "mir/data/MIRField.h"
 #include "mir/param/MIRParametrisation.h"
+#include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
 #include "mir/util/Mutex.h"
 
 
 namespace mir::action {
 
 
-static util::once_flag once;
-static eckit::ThreadPool* pool = nullptr;
-static void init() {
-    pool = new eckit::ThreadPool("executor", 2);
+namespace {
+
+
+using clock_type = std::chrono::steady_clock;
+
+
+size_t default_threads() {
+    static const long threads = eckit::Resource<long>("$MIR_EXECUTOR_THREADS", 0);
+    return threads > 0 ? size_t(threads) : std::max(1U, std::thread::hardware_concurrency());
 }
 
 
-class ThreadExecutorTask : public eckit::ThreadPoolTask {
+size_t default_memory() {
+    static const size_t memory = eckit::Resource<size_t>("$MIR_EXECUTOR_MEMORY", 0);
+    return memory;
+}
+
+
+/// Estimated memory held by a task (the field values it carries), 0 if the field is not yet decoded
+size_t footprint(context::Context& ctx) {
+    if (!ctx.isField()) {
+        return 0;
+    }
+
+    const auto& field = ctx.field();
+
+    size_t size = 0;
+    for (size_t d = 0; d < field.dimensions(); ++d) {
+        size += field.values(d).size() * sizeof(double);
+    }
+    return size;
+}
+
+
+struct Task {
+    Task(const ThreadExecutor& owner, context::Context& ctx, const ActionNode& node, size_t footprint) :
+        owner_(owner), ctx_(ctx), node_(node), footprint_(footprint), queued_(clock_type::now()) {}
+
     const ThreadExecutor& owner_;
     context::Context ctx_;  // Not a reference, so we have a copy
     const ActionNode& node_;
+    const size_t footprint_;
+    const clock_type::time_point queued_;
+};
 
-    void execute() override {
-        Log::info() << "===> Execute " << node_ << std::endl;
-        node_.execute(ctx_, owner_);
-        Log::info() << "<=== Done " << node_ << std::endl;
-    }
 
+/*
+ * Pool of worker threads sharing one task queue. Tasks spawned by a running task (the children of an ActionNode) go
+ * to the front of the queue, so subgraphs complete depth-first and the number of fields alive stays small; top-level
+ * nodes go to the back. Tasks whose estimated footprint would exceed the memory bound run on the submitting thread.
+ * The tasks' MIRStatistics account for the queue depth, time queued, time executing and threads time available.
+ */
+class Pool {
 public:
-    ThreadExecutorTask(const ThreadExecutor& owner, context::Context& ctx, const ActionNode& node) :
-        owner_(owner), ctx_(ctx), node_(node) {}
-    ~ThreadExecutorTask() override = default;
-
-    ThreadExecutorTask(const ThreadExecutorTask&)            = delete;
-    ThreadExecutorTask(ThreadExecutorTask&&)                 = delete;
-    ThreadExecutorTask& operator=(const ThreadExecutorTask&) = delete;
-    ThreadExecutorTask& operator=(ThreadExecutorTask&&)      = delete;
+    static Pool& instance() {
+        static auto* pool = new Pool;  // never destroyed: detached workers may outlive static destruction
+        return *pool;
+    }
+
+    void resize(size_t threads) {
+        ASSERT(threads > 0);
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        while (spawned_ < threads) {
+            std::thread(&Pool::worker, this, spawned_++).detach();
+        }
+
+        size_ = threads;
+        work_.notify_all();
+    }
+
+    void memory(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        memoryLimit_ = bytes;
+    }
+
+    size_t threads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    bool reserve(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (memoryLimit_ > 0 && memory_ > 0 && memory_ + bytes > memoryLimit_) {
+            return false;
+        }
+        memory_ += bytes;
+        return true;
+    }
+
+    void push(std::unique_ptr<Task> task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty() && running_ == 0) {
+            start_ = clock_type::now();
+        }
+
+        auto& stats = task->ctx_.statistics();
+
+        if (current_ != nullptr) {
+            queue_.push_front(std::move(task));
+        }
+        else {
+            queue_.push_back(std::move(task));
+        }
+
+        stats.executorQueueDepth(queue_.size());
+
+        // all workers are woken, as disabled ones (beyond size_, after shrinking) would not take the task
+        work_.notify_all();
+    }
+
+    void error(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+            error_ = e;
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return queue_.empty() && running_ == 0; });
+
+        if (error_) {
+            auto e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    /// Task being executed by the calling thread, if it is a worker (to identify child tasks)
+    static thread_local const Task* current_;
+
+private:
+    Pool() = default;
+
+    void worker(size_t id) {
+        for (;;) {
+            std::unique_ptr<Task> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_.wait(lock, [this, id] { return id < size_ && !queue_.empty(); });
+
+                task = std::move(queue_.front());
+                queue_.pop_front();
+                ++running_;
+            }
+
+            const auto start = clock_type::now();
+            try {
+                current_ = task.get();
+                Log::info() << "===> Execute " << task->node_ << std::endl;
+                task->node_.execute(task->ctx_, task->owner_);
+                Log::info() << "<=== Done " << task->node_ << std::endl;
+            }
+            catch (...) {
+                error(std::current_exception());
+            }
+            current_ = nullptr;
+
+            const auto end = clock_type::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                const double queued = std::chrono::duration<double>(start - task->queued_).count();
+                const double busy   = std::chrono::duration<double>(end - start).count();
+
+                auto& stats = task->ctx_.statistics();
+                stats.executorQueueTiming().elapsed_ += queued;
+                stats.executorQueueTiming().updates_++;
+                stats.executorTiming().elapsed_ += busy;
+                stats.executorTiming().updates_++;
+
+                --running_;
+                const bool idle = queue_.empty() && running_ == 0;
+
+                // threads time available since the pool was last idle (pool-wide, accounted to the last task)
+                if (idle) {
+                    const double wall = std::chrono::duration<double>(end - start_).count();
+                    stats.executorCapacityTiming().elapsed_ += wall * double(size_);
+                    stats.executorCapacityTiming().updates_++;
+                }
+
+                ASSERT(memory_ >= task->footprint_);
+                memory_ -= task->footprint_;
+                task.reset();
+
+                if (idle) {
+                    done_.notify_all();
+                }
+            }
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_;
+    std::condition_variable done_;
+    std::deque<std::unique_ptr<Task>> queue_;
+    std::exception_ptr error_;
+
+    size_t spawned_     = 0;
+    size_t size_        = 0;
+    size_t running_     = 0;
+    size_t memory_      = 0;
+    size_t memoryLimit_ = 0;
+
+    clock_type::time_point start_;
 };
 
 
+thread_local const Task* Pool::current_ = nullptr;
+
+
+util::once_flag once;
+void init() {
+    Pool::instance().resize(default_threads());
+    Pool::instance().memory(default_memory());
+}
+
+
+}  // namespace
+
+
 ThreadExecutor::ThreadExecutor(const std::string& name) : Executor(name) {}
 
 
 void ThreadExecutor::print(std::ostream& out) const {
-    out << "ThreadExecutor[]";
+    util::call_once(once, init);
+    out << "ThreadExecutor[threads=" << Pool::instance().threads() << "]";
 }
 
 
 void ThreadExecutor::wait() const {
     util::call_once(once, init);
-    pool->wait();
+    Pool::instance().wait();
 }
 
 
 void ThreadExecutor::execute(context::Context& ctx, const ActionNode& node) const {
     util::call_once(once, init);
-    pool->push(new ThreadExecutorTask(*this, ctx, node));
+    auto& pool = Pool::instance();
+
+    const auto size = footprint(ctx);
+    if (pool.reserve(size)) {
+        pool.push(std::make_unique<Task>(*this, ctx, node, size));
+        return;
+    }
+
+    // Over the memory bound: run on this thread, which also holds back the producer
+    Log::debug() << "ThreadExecutor: memory bound reached, executing " << node << " inline" << std::endl;
+    try {
+        node.execute(ctx, *this);
+    }
+    catch (...) {
+        pool.error(std::current_exception());
+    }
 }
 
 
 void ThreadExecutor::parametrisation(const param::MIRParametrisation& parametrisation) {
     util::call_once(once, init);
-    size_t threads;
-    if (parametrisation.get("executor.threads", threads)) {
-        pool->resize(threads);
-    }
+
+    size_t threads = default_threads();
+    parametrisation.get("executor.threads", threads);
+    Pool::instance().resize(threads > 0 ? threads : std::max(1U, std::thread::hardware_concurrency()));
+
+    size_t memory = default_memory();
+    parametrisation.get("executor.memory", memory);
+    Pool::instance().memory(memory);
 }
 
 
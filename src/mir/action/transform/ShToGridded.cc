@@ -12,6 +12,9 @@
 
 #include "mir/action/transform/ShToGridded.h"
 
+#include <future>
+#include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
 
@@ -23,7 +26,7 @@
 #include "mir/action/transform/TransCache.h"
 #include "mir/api/MIREstimation.h"
 #include "mir/caching/InMemoryCache.h"
-#include "mir/caching/LegendreCache.h"
+#include "mir/caching/legendre/LegendreBuilder.h"
 #include "mir/caching/legendre/LegendreLoader.h"
 #include "mir/config/LibMir.h"
 #include "mir/data/MIRField.h"
@@ -44,14 +47,15 @@ constexpr size_t CAPACITY_SHARED = CAPACITY_MEMORY;
 static caching::InMemoryCache<TransCache> trans_cache("mirCoefficient", CAPACITY_MEMORY, CAPACITY_SHARED,
                                                       "$MIR_COEFFICIENT_CACHE");
 
+using trans_handle_t = caching::InMemoryCache<TransCache>::handle_type;
 
-static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& creator, const std::string& key,
-                                         const param::MIRParametrisation& parametrisation, context::Context& ctx) {
-    auto j = trans_cache.find(key);
-    if (j != trans_cache.end()) {
-        ASSERT(j->transCache_);
-        return j->transCache_;
-    }
+static util::recursive_mutex trans_in_flight_mutex;
+static std::map<std::string, std::shared_future<trans_handle_t>> trans_in_flight;
+
+
+static trans_handle_t getTransCache(atlas::trans::LegendreCacheCreator& creator, const std::string& key,
+                                    const param::MIRParametrisation& parametrisation, context::Context& ctx) {
+    ASSERT(!trans_cache.find(key));
 
 
     // Make sure we have enough space in cache to add new coefficients
@@ -63,44 +67,13 @@ static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& cre
     {
         // Block for timers
         auto timing(ctx.statistics().coefficientTimer());
-
-        class LegendreCacheCreator final : public caching::LegendreCache::CacheContentCreator {
-
-            atlas::trans::LegendreCacheCreator& creator_;
-            context::Context& ctx_;
-
-            void create(const eckit::PathName& path, caching::LegendreCacheTraits::value_type& /*ignore*/,
-                        bool& saved) override {
-                trace::ResourceUsage usage("ShToGridded: create Legendre coefficients");
-                auto timing(ctx_.statistics().createCoeffTimer());
-
-                // This will create the cache
-                Log::info() << "ShToGridded: create Legendre coefficients '" + path + "'" << std::endl;
-                creator_.create(path);
-
-                saved = path.exists();
-            }
-
-        public:
-            LegendreCacheCreator(atlas::trans::LegendreCacheCreator& creator, context::Context& ctx) :
-                creator_(creator), ctx_(ctx) {}
-            ~LegendreCacheCreator() override = default;
-
-            LegendreCacheCreator(const LegendreCacheCreator&)            = delete;
-            LegendreCacheCreator(LegendreCacheCreator&&)                 = delete;
-            LegendreCacheCreator& operator=(const LegendreCacheCreator&) = delete;
-            LegendreCacheCreator& operator=(LegendreCacheCreator&&)      = delete;
-        };
-
-        static caching::LegendreCache cache;
-        LegendreCacheCreator create(creator, ctx);
-
-        int dummy = 0;
-        path      = cache.getOrCreate(key, create, dummy);
+        path = caching::legendre::LegendreBuilder::build(creator, ctx.statistics());
     }
 
 
-    TransCache& tc                  = trans_cache[key];
+    // entry is inserted once complete (concurrent lookups should not see it partially loaded)
+    std::unique_ptr<TransCache> entry(new TransCache);
+    TransCache& tc                  = *entry;
     atlas::trans::Cache& transCache = tc.transCache_;
 
     {
@@ -123,11 +96,63 @@ static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& cre
         size_t memory                                    = 0;
         size_t shared                                    = 0;
         (tc.loader_->inSharedMemory() ? shared : memory) = tc.loader_->size();
-        trans_cache.footprint(key, caching::InMemoryCacheUsage(memory, shared));
+
+        ASSERT(transCache);
+        return trans_cache.insert(key, entry.release(), caching::InMemoryCacheUsage(memory, shared));
+    }
+}
+
+
+static trans_handle_t createTransCache(atlas::trans::LegendreCacheCreator& creator, const std::string& key) {
+    std::unique_ptr<TransCache> entry(new TransCache);
+    *entry = creator.create();
+    ASSERT(entry->transCache_);
+
+    return trans_cache.insert(key, entry.release());
+}
+
+
+/// Create/load Legendre coefficients into a cache entry (returning a handle, so it is not purged while in use): this is
+/// done once per key, concurrent transforms with the same key wait for it (sharing its entry), others do not
+static trans_handle_t transCache(atlas::trans::LegendreCacheCreator& creator, const std::string& key, bool caching,
+                                 const param::MIRParametrisation& parametrisation, context::Context& ctx) {
+    std::promise<trans_handle_t> promise;
+    std::shared_future<trans_handle_t> future;
+
+    {
+        util::lock_guard<util::recursive_mutex> lock(trans_in_flight_mutex);
+
+        if (auto k = trans_in_flight.find(key); k != trans_in_flight.end()) {
+            future = k->second;
+        }
+        else if (auto entry = trans_cache.find(key); entry) {
+            // created since the caller's lookup
+            return entry;
+        }
+        else {
+            trans_in_flight.emplace(key, promise.get_future().share());
+        }
     }
 
-    ASSERT(transCache);
-    return transCache;
+    if (future.valid()) {
+        return future.get();  // rethrows if creation failed
+    }
+
+    try {
+        auto entry = caching ? getTransCache(creator, key, parametrisation, ctx) : createTransCache(creator, key);
+        ASSERT(entry && entry->transCache_);
+
+        util::lock_guard<util::recursive_mutex> lock(trans_in_flight_mutex);
+        trans_in_flight.erase(key);
+        promise.set_value(entry);
+        return entry;
+    }
+    catch (...) {
+        util::lock_guard<util::recursive_mutex> lock(trans_in_flight_mutex);
+        trans_in_flight.erase(key);
+        promise.set_exception(std::current_exception());
+        throw;
+    }
 }
 
 
@@ -140,12 +165,8 @@ static eckit::Hash::digest_t atlasOptionsDigest(const ShToGridded::atlas_config_
 
 void ShToGridded::transform(data::MIRField& field, const repres::Representation& representation,
                             context::Context& ctx) const {
-    static util::recursive_mutex local_mutex;
-    util::lock_guard<util::recursive_mutex> lock(local_mutex);  // To protect trans_cache
-
-    // Make sure another thread to no evict anything from the cache while we are using it
-    // FIXME check if it should be in ::execute()
-    auto cacheUse(ctx.statistics().cacheUser(trans_cache));
+    // FFT planning (building/destroying transforms) is not thread-safe
+    auto& trans_mutex = caching::legendre::LegendreBuilder::transMutex();
 
 
     atlas::Grid grid = representation.atlasGrid();
@@ -172,39 +193,41 @@ void ShToGridded::transform(data::MIRField& field, const repres::Representation&
     const std::string key(creator.uid());
     ASSERT(!key.empty());
 
-    atlas_trans_t trans;
+    // transform (destroyed under lock, also on exception) and its (shared, read-only) coefficients
+    struct Trans {
+        atlas_trans_t trans;
+        trans_handle_t entry;
+        ~Trans() {
+            util::lock_guard<util::recursive_mutex> lock(caching::legendre::LegendreBuilder::transMutex());
+            trans = atlas_trans_t();
+        }
+    } t;
+
     try {
         trace::Timer time("ShToGridded::caching");
 
         bool caching = LibMir::caching();
         parametrisation_.get("caching", caching);
 
-        auto j = trans_cache.find(key);
-        if (j != trans_cache.end()) {
-
-            ASSERT(j->transCache_);
-            trans = atlas_trans_t(j->transCache_, grid, domain, truncation, options_);
-        }
-        else if (!creator.supported()) {
+        t.entry = trans_cache.find(key);
+        if (!t.entry && !creator.supported()) {
 
             Log::warning() << "ShToGridded: LegendreCacheCreator is not supported for:"
                            << "\n  representation: " << representation << "\n  options: " << options_ << std::endl
                            << "ShToGridded: continuing with hindered performance" << std::endl;
 
-            trans = atlas_trans_t(grid, domain, truncation, options_);
-        }
-        else if (!caching) {
-
-            auto& entry(trans_cache[key] = creator.create());
-            ASSERT(entry.transCache_);
-            trans = atlas_trans_t(entry.transCache_, grid, domain, truncation, options_);
+            util::lock_guard<util::recursive_mutex> lock(trans_mutex);
+            t.trans = atlas_trans_t(grid, domain, truncation, options_);
         }
         else {
 
-            ASSERT(creator.supported());
-            atlas::trans::Cache transCache = getTransCache(creator, key, parametrisation_, ctx);
-            ASSERT(transCache);
-            trans = atlas_trans_t(transCache, grid, domain, truncation, options_);
+            if (!t.entry) {
+                t.entry = transCache(creator, key, caching, parametrisation_, ctx);
+            }
+            ASSERT(t.entry && t.entry->transCache_);
+
+            util::lock_guard<util::recursive_mutex> lock(trans_mutex);
+            t.trans = atlas_trans_t(t.entry->transCache_, grid, domain, truncation, options_);
         }
     }
     catch (std::exception& e) {
@@ -212,12 +235,15 @@ void ShToGridded::transform(data::MIRField& field, const repres::Representation&
         trans_cache.erase(key);
         throw;
     }
-    ASSERT(trans);
+    ASSERT(t.trans);
+
+    ctx.statistics().cacheStatistics(trans_cache);
 
+    // transforms run concurrently
     try {
 
         auto time(ctx.statistics().sh2gridTimer());
-        sh2grid(field, trans, parametrisation_);
+        sh2grid(field, t.trans, parametrisation_);
     }
     catch (std::exception& e) {
         Log::error() << "ShToGridded::transform: " << e.what() << std::endl;
@@ -13,6 +13,11 @@
 #include <sys/time.h>
 #include <time.h>
 
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 #include "mir/caching/InMemoryCache.h"
 #include "mir/caching/InMemoryCacheStatistics.h"
 #include "mir/util/Exceptions.h"
@@ -35,66 +40,76 @@ InMemoryCache<T>::InMemoryCache(const std::string& name, size_t memory_capacity,
                                 const char* variable) :
     name_(name),
     capacity_(name + "InMemoryCacheCapacity;" + variable, InMemoryCacheUsage(memory_capacity, shared_capacity)),
-    users_(0) {}
+    hits_(0),
+    misses_(0),
+    tick_(0) {}
 
 
 template <class T>
-InMemoryCache<T>::~InMemoryCache() {
-    // Log::debug() << "Deleting InMemoryCache " << name_ << " capacity=" << capacity_ << ", entries: " <<
-    // cache_.size() << std::endl;
-    for (auto& j : cache_) {
-        // Log::debug() << "Deleting InMemoryCache " << name_ << " " << *(j.second->ptr_) << std::endl;
-        delete j.second;
-    }
-
-    // std::string title = "InMemoryCache(" + name_ + ")";
-    // statistics_.report(title.c_str(), Log::debug());
-}
+InMemoryCache<T>::~InMemoryCache() = default;
 
 
 template <class T>
-T* InMemoryCache<T>::find(const std::string& key) const {
-    util::lock_guard<util::recursive_mutex> lock(mutex_);
+typename InMemoryCache<T>::Shard& InMemoryCache<T>::shard(const std::string& key) const {
+    return shards_[std::hash<std::string>{}(key) % SHARDS];
+}
 
-    auto j = cache_.find(key);
-    if (j != cache_.end()) {
-        statistics_.hits_++;
 
-        j->second->hits_++;
-        j->second->last_ = utime();
-        return j->second->ptr_.get();
+template <class T>
+typename InMemoryCache<T>::handle_type InMemoryCache<T>::find(const std::string& key) const {
+    auto& s = shard(key);
+    std::shared_lock<std::shared_mutex> lock(s.mutex_);
+
+    auto j = s.cache_.find(key);
+    if (j != s.cache_.end()) {
+        hits_++;
+
+        auto& entry = *(j->second);
+        entry.hits_++;
+        entry.tick_ = ++tick_;
+        entry.last_ = utime();
+        return entry.ptr_;
     }
-    // if (statistics_) {
-    //     statistics_.misses_++;
-    // }
+
+    misses_++;
     return nullptr;
 }
 
 
 template <class T>
 void InMemoryCache<T>::footprint(const std::string& key, const InMemoryCacheUsage& usage) {
-    util::lock_guard<util::recursive_mutex> lock(mutex_);
+    {
+        util::lock_guard<util::recursive_mutex> lock(mutex_);
+
+        Log::debug() << "CACHE-FOOTPRINT-" << name_ << " " << key << " => " << usage << std::endl;
 
-    Log::debug() << "CACHE-FOOTPRINT-" << name_ << " " << key << " => " << usage << std::endl;
+        {
+            // the entry might have been erased meanwhile
+            auto& s = shard(key);
+            std::unique_lock<std::shared_mutex> lock(s.mutex_);
 
+            auto k = s.cache_.find(key);
+            if (k == s.cache_.end()) {
+                return;
+            }
+            k->second->footprint_ = usage;
+        }
+        keys_[key] = usage;
 
-    auto k = cache_.find(key);
-    ASSERT(k != cache_.end());
-    k->second->footprint_ = usage;
-    keys_[key]            = usage;
+        InMemoryCacheUsage result;
+        for (auto j = keys_.begin(); j != keys_.end(); ++j) {
+            result += j->second;
+        }
 
-    footprint();  //  Update stats
+        statistics_.required_ = result;
 
+        Log::debug() << "CACHE-FOOTPRINT-" << name_ << " total " << footprint() << " required " << result
+                     << " capacity " << capacity_ << std::endl;
 
-    InMemoryCacheUsage result;
-    for (auto j = keys_.begin(); j != keys_.end(); ++j) {
-        result += j->second;
+        purge();
     }
 
-    statistics_.required_ = result;
-
-    Log::debug() << "CACHE-FOOTPRINT-" << name_ << " total " << footprint() << " required " << result << " capacity "
-                 << capacity_ << std::endl;
+    checkTotalFootprint();
 }
 
 
@@ -125,55 +140,39 @@ void InMemoryCache<T>::reserve(const InMemoryCacheUsage& usage) {
 
 
 template <class T>
-T& InMemoryCache<T>::operator[](const std::string& key) {
-    util::lock_guard<util::recursive_mutex> lock(mutex_);
-
-    T* ptr = find(key);
-    return ptr == nullptr ? create(key) : *ptr;
-}
-
-static inline double score(size_t /*count*/, double recent, double /*age*/) {
-    // count: number of accesses
-    // age: age in seconds since creation
-    // recent: age in seconds since last access
-
-    // The higher the score, the most likely to be deleted
+typename InMemoryCache<T>::handle_type InMemoryCache<T>::insert(const std::string& key, T* ptr,
+                                                                const InMemoryCacheUsage& footprint) {
+    ASSERT(ptr);
 
-    // return (double(recent) + double(age)) / double(count);
+    handle_type result;
+    {
+        util::lock_guard<util::recursive_mutex> lock(mutex_);
 
-    return recent;  // LRU
-}
+        statistics_.insertions_++;
 
+        {
+            auto& s = shard(key);
+            std::unique_lock<std::shared_mutex> lock(s.mutex_);
 
-template <class T>
-T& InMemoryCache<T>::insert(const std::string& key, T* ptr) {
-    util::lock_guard<util::recursive_mutex> lock(mutex_);
-
-    ASSERT(ptr);
+            auto& entry = s.cache_[key];
+            if (entry) {
+                NOTIMP;  // Needs to think more about it
+            }
 
-    statistics_.insertions_++;
+            entry.reset(new Entry(ptr, ++tick_, utime(), footprint));
+            result = entry->ptr_;
+        }
 
-    // Log::debug() << "Insert in InMemoryCache " << *ptr << std::endl;
+        keys_[key] = footprint;
 
-    auto k = cache_.find(key);
-    if (k != cache_.end()) {
-        NOTIMP;  // Needs to think more about it
-        delete k->second;
-        k->second  = new Entry(ptr);
-        keys_[key] = InMemoryCacheUsage(size_t(1), size_t(0));
-        return *ptr;
-    }
+        statistics_.unique_ = keys_.size();
 
-    if (users_ == 0) {
+        // the new entry is in use (result), so it is not purged
         purge();
     }
 
-    cache_[key] = new Entry(ptr);
-    keys_[key]  = InMemoryCacheUsage(size_t(1), size_t(0));
-
-    statistics_.unique_ = keys_.size();
-
-    return *ptr;
+    checkTotalFootprint();
+    return result;
 }
 
 template <class T>
@@ -187,10 +186,15 @@ void InMemoryCache<T>::purge() {
 
 template <class T>
 InMemoryCacheUsage InMemoryCache<T>::footprint() const {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+
     InMemoryCacheUsage result;
 
-    for (auto j = cache_.begin(); j != cache_.end(); ++j) {
-        result += j->second->footprint_;
+    for (auto& s : shards_) {
+        std::shared_lock<std::shared_mutex> lock(s.mutex_);
+        for (auto j = s.cache_.begin(); j != s.cache_.end(); ++j) {
+            result += j->second->footprint_;
+        }
     }
 
     if (result > statistics_.footprint_) {
@@ -200,29 +204,13 @@ InMemoryCacheUsage InMemoryCache<T>::footprint() const {
     return result;
 }
 
-template <class T>
-T& InMemoryCache<T>::create(const std::string& key) {
-    return insert(key, new T());
-}
 
 template <class T>
-void InMemoryCache<T>::startUsing() {
+void InMemoryCache<T>::statistics(InMemoryCacheStatistics& statistics) const {
     util::lock_guard<util::recursive_mutex> lock(mutex_);
-    users_++;
-}
-
-template <class T>
-void InMemoryCache<T>::stopUsing(InMemoryCacheStatistics& statistics) {
-    util::lock_guard<util::recursive_mutex> lock(mutex_);
-
-    ASSERT(users_);
-    users_--;
-    if (users_ == 0) {
-        purge();
-    }
-
-    checkTotalFootprint();
 
+    statistics_.hits_     = hits_;
+    statistics_.misses_   = misses_;
     statistics_.capacity_ = capacity_;
     statistics            = statistics_;
 }
@@ -232,11 +220,10 @@ template <class T>
 void InMemoryCache<T>::erase(const std::string& key) {
     util::lock_guard<util::recursive_mutex> lock(mutex_);
 
-    auto j = cache_.find(key);
-    if (j != cache_.end()) {
-        delete j->second;
-        cache_.erase(j);
-    }
+    auto& s = shard(key);
+    std::unique_lock<std::shared_mutex> lock_shard(s.mutex_);
+
+    s.cache_.erase(key);
 }
 
 template <class T>
@@ -252,33 +239,48 @@ const std::string& InMemoryCache<T>::name() const {
 
 
 template <class T>
-InMemoryCacheUsage InMemoryCache<T>::purge(const InMemoryCacheUsage& amount, bool force) {
-    InMemoryCacheUsage purged;
+InMemoryCacheUsage InMemoryCache<T>::purge(const InMemoryCacheUsage& amount, bool /*force*/) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
 
-    if (users_ && !force) {
-        return purged;
-    }
+    InMemoryCacheUsage purged;
 
     Log::debug() << "CACHE " << name_ << " purging " << amount << std::endl;
 
-    while (purged < amount) {
+    // candidates in least recently used order, collected once (entries in use are skipped)
+    struct Candidate {
+        size_t tick;
+        Shard* shard;
+        std::string key;
+        bool operator<(const Candidate& other) const { return tick < other.tick; }
+    };
+
+    std::vector<Candidate> candidates;
+    for (auto& s : shards_) {
+        std::shared_lock<std::shared_mutex> lock(s.mutex_);
+        for (const auto& j : s.cache_) {
+            if (j.second->ptr_.use_count() == 1) {
+                candidates.push_back({j.second->tick_, &s, j.first});
+            }
+        }
+    }
 
-        if (cache_.empty()) {
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& c : candidates) {
+        if (!(purged < amount)) {
             break;
         }
 
-        double now = utime();
-        auto best  = cache_.begin();
-        double m   = 0;
+        // checked and erased under the same (exclusive) lock: a handle cannot be taken meanwhile
+        std::unique_lock<std::shared_mutex> lock(c.shard->mutex_);
 
-        for (auto j = cache_.begin(); j != cache_.end(); ++j) {
-            double s = score(j->second->hits_, now - j->second->last_, now - j->second->insert_);
-            if (s > m) {
-                m    = s;
-                best = j;
-            }
+        auto j = c.shard->cache_.find(c.key);
+        if (j == c.shard->cache_.end() || j->second->ptr_.use_count() != 1 || j->second->tick_ != c.tick) {
+            continue;  // erased, in use or used since
         }
 
+        double m = utime() - j->second->last_;
+
         if (m < statistics_.youngest_ || statistics_.youngest_ == 0) {
             statistics_.youngest_ = m;
         }
@@ -290,11 +292,10 @@ InMemoryCacheUsage InMemoryCache<T>::purge(const InMemoryCacheUsage& amount, boo
         statistics_.evictions_++;
 
 
-        purged += best->second->footprint_;
+        purged += j->second->footprint_;
 
-        Log::debug() << "CACHE " << name_ << " decache " << best->first << std::endl;
-        delete best->second;
-        cache_.erase(best);
+        Log::debug() << "CACHE " << name_ << " decache " << j->first << std::endl;
+        c.shard->cache_.erase(j);
 
         Log::debug() << "CACHE " << name_ << " purging " << amount << " purged " << purged << std::endl;
     }
@@ -12,7 +12,12 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <shared_mutex>
+#include <string>
 
 #include "eckit/config/Resource.h"
 
@@ -25,22 +30,27 @@ namespace mir {
 namespace caching {
 
 
+/**
+ * In-memory cache of reference-counted entries, purged least recently used first within a capacity. Entries with
+ * live handles are not purged, and an entry removed while in use is destroyed with its last handle.
+ */
 template <class T>
 class InMemoryCache : public InMemoryCacheBase {
 
 public:  // methods
-    using iterator = T*;
+    using handle_type = std::shared_ptr<T>;
 
     explicit InMemoryCache(const std::string& name, size_t memory_capacity, size_t shared_capacity,
                            const char* variable);
 
     ~InMemoryCache() override;
 
-    iterator find(const std::string& key) const;
-    T& insert(const std::string& key, T*);
-    T& operator[](const std::string& key);
+    /// Entry handle (null if key not found)
+    handle_type find(const std::string& key) const;
 
-    iterator end() const { return nullptr; }
+    /// Insert an entry (key not in use), with its footprint, returning its handle
+    handle_type insert(const std::string& key, T*,
+                       const InMemoryCacheUsage& footprint = InMemoryCacheUsage(size_t(1), size_t(0)));
 
     void footprint(const std::string& key, const InMemoryCacheUsage&);
     const std::string& name() const override;
@@ -50,58 +60,50 @@ public:  // methods
 
     void erase(const std::string& key);
 
-    void startUsing();
-    void stopUsing(InMemoryCacheStatistics&);
+    /// Copy the cache statistics
+    void statistics(InMemoryCacheStatistics&) const;
 
 private:
     void purge();
-    T& create(const std::string& key);
 
     InMemoryCacheUsage footprint() const override;
     InMemoryCacheUsage capacity() const override;
     InMemoryCacheUsage purge(const InMemoryCacheUsage&, bool force = false) override;
 
-    std::string name_;
-    eckit::Resource<InMemoryCacheUsage> capacity_;
-    size_t users_;
-    mutable InMemoryCacheStatistics statistics_;
-    mutable std::map<std::string, InMemoryCacheUsage> keys_;
-    mutable util::recursive_mutex mutex_;
-
     struct Entry {
-        std::unique_ptr<T> ptr_;
-        size_t hits_;
-        double last_;
+        std::shared_ptr<T> ptr_;
+        std::atomic<size_t> hits_;
+        std::atomic<size_t> tick_;
+        std::atomic<double> last_;
         double insert_;
         InMemoryCacheUsage footprint_;
 
-        Entry(T* ptr) :
-            ptr_(ptr),
-            hits_(1),
-            last_(double(::time(nullptr))),
-            insert_(double(::time(nullptr))),
-            footprint_(size_t(1), size_t(0)) {}
+        Entry(T* ptr, size_t tick, double now, const InMemoryCacheUsage& footprint) :
+            ptr_(ptr), hits_(1), tick_(tick), last_(now), insert_(now), footprint_(footprint) {}
     };
 
-    std::map<std::string, Entry*> cache_;
-};
+    // Entries are spread over shards (by key hash), so that concurrent lookups (under a shared lock) of different
+    // keys do not contend; modifications hold mutex_ (taken first) and the shard exclusive lock. Access ticks and
+    // times are atomic, as lookups update them under the shared lock
+    struct Shard {
+        mutable std::shared_mutex mutex_;
+        std::map<std::string, std::unique_ptr<Entry>> cache_;
+    };
 
-template <class T>
-class InMemoryCacheUser {
-    InMemoryCache<T>& cache_;
-    InMemoryCacheStatistics& statistics_;
+    static constexpr size_t SHARDS = 16;
 
-    InMemoryCacheUser(const InMemoryCacheUser&)            = delete;
-    InMemoryCacheUser& operator=(const InMemoryCacheUser&) = delete;
+    Shard& shard(const std::string& key) const;
 
-public:
-    InMemoryCacheUser(InMemoryCacheUser&&) = default;
-    InMemoryCacheUser(InMemoryCache<T>& cache, InMemoryCacheStatistics& statistics) :
-        cache_(cache), statistics_(statistics) {
-        cache_.startUsing();
-    }
+    std::string name_;
+    eckit::Resource<InMemoryCacheUsage> capacity_;
+    mutable InMemoryCacheStatistics statistics_;
+    mutable std::map<std::string, InMemoryCacheUsage> keys_;
+    mutable util::recursive_mutex mutex_;
 
-    ~InMemoryCacheUser() { cache_.stopUsing(statistics_); }
+    mutable std::array<Shard, SHARDS> shards_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+    mutable std::atomic<size_t> tick_;  // access counter, for exact LRU ordering
 };
 
 
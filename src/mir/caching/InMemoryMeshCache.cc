@@ -47,7 +47,6 @@ atlas::Mesh InMemoryMeshCache::atlasMesh(util::MIRStatistics& statistics, const
 
     auto& log = Log::debug();
     trace::ResourceUsage usage_mesh("Mesh for grid " + grid.name() + " (" + grid.uid() + ")");
-    auto cacheUse(statistics.cacheUser(mesh_cache));
 
     // generate signature including the mesh generation settings
     eckit::MD5 md5;
@@ -55,13 +54,13 @@ atlas::Mesh InMemoryMeshCache::atlasMesh(util::MIRStatistics& statistics, const
     md5 << meshGeneratorParams;
 
     auto sign(md5.digest());
-    auto j = mesh_cache.find(sign);
-    if (j != mesh_cache.end()) {
+    if (auto j = mesh_cache.find(sign); j) {
+        statistics.cacheStatistics(mesh_cache);
         return *j;
     }
 
-    atlas::Mesh& mesh = mesh_cache[sign];
-    ASSERT(!mesh.generated());
+    // entry is inserted once complete
+    atlas::Mesh mesh;
 
     try {
         log << "InMemoryMeshCache: generating mesh using " << meshGeneratorParams << std::endl;
@@ -124,14 +123,16 @@ atlas::Mesh InMemoryMeshCache::atlasMesh(util::MIRStatistics& statistics, const
         }
     }
     catch (...) {
-        // Make sure we don't leave an incomplete entry in the cache
-        mesh_cache.erase(sign);
+        Log::error() << "InMemoryMeshCache: failed to generate mesh using " << meshGeneratorParams << std::endl;
         throw;
     }
 
-    mesh_cache.footprint(sign, InMemoryCacheUsage(mesh.footprint(), 0));
-
     ASSERT(mesh.generated());
+
+    const InMemoryCacheUsage footprint(mesh.footprint(), size_t(0));
+    mesh_cache.insert(sign, new atlas::Mesh(mesh), footprint);
+    statistics.cacheStatistics(mesh_cache);
+
     return mesh;
 }
 
@@ -46,7 +46,7 @@ const char* WeightCacheTraits::name() {
 
 
 int WeightCacheTraits::version() {
-    return 15;
+    return 16;
 }
 
 
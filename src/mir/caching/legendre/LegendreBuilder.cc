@@ -0,0 +1,335 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/caching/legendre/LegendreBuilder.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "eckit/utils/StringTools.h"
+#include "eckit/utils/Translator.h"
+
+#include "mir/caching/LegendreCache.h"
+#include "mir/key/grid/Grid.h"
+#include "mir/param/MIRParametrisation.h"
+#include "mir/repres/Representation.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
+#include "mir/util/Trace.h"
+
+
+namespace mir::caching::legendre {
+
+
+namespace {
+
+
+/// In a worker process, building transforms does not need the (process-wide) transforms lock
+bool subprocess = false;
+
+
+bool create(const LegendreBuilder::Request& r) {
+    atlas::trans::LegendreCacheCreator creator(r.grid, r.truncation, r.options);
+    if (!creator.supported()) {
+        Log::warning() << "LegendreBuilder: Legendre coefficients not supported for " << r << std::endl;
+        return false;
+    }
+
+    util::MIRStatistics statistics;
+    LegendreBuilder::build(creator, statistics);
+    return true;
+}
+
+
+/// Background builds, one at a time and once per cache key, in a single thread (in-process: forking a multi-threaded
+/// process could leave the child with locks held by other threads)
+class Background {
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<LegendreBuilder::Request> queue_;
+    std::set<std::string> keys_;
+    std::thread thread_;
+    bool busy_ = false;
+    bool stop_ = false;
+
+    void worker() {
+        for (;;) {
+            LegendreBuilder::Request r;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [&] { return !queue_.empty() || stop_; });
+                if (stop_) {
+                    return;
+                }
+
+                r = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+            }
+
+            try {
+                Log::debug() << "LegendreBuilder: building in the background " << r << std::endl;
+                if (!create(r)) {
+                    Log::warning() << "LegendreBuilder: background build failed for " << r << std::endl;
+                }
+            }
+            catch (std::exception& e) {
+                Log::warning() << "LegendreBuilder: background build failed for " << r << ": " << e.what()
+                               << std::endl;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+            cond_.notify_all();
+        }
+    }
+
+public:
+    ~Background() {
+        {
+            // pending builds are dropped (a build in progress is finished)
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            queue_.clear();
+            cond_.notify_all();
+        }
+
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    static Background& instance() {
+        static Background background;
+        return background;
+    }
+
+    void push(const LegendreBuilder::Request& r, const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_ || !keys_.insert(key).second) {
+            return;
+        }
+
+        queue_.emplace_back(r);
+        if (!thread_.joinable()) {
+            thread_ = std::thread(&Background::worker, this);
+        }
+        cond_.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [&] { return (queue_.empty() && !busy_) || stop_; });
+    }
+
+    bool started() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return thread_.joinable();
+    }
+};
+
+
+}  // namespace
+
+
+eckit::PathName LegendreBuilder::build(atlas::trans::LegendreCacheCreator& creator, util::MIRStatistics& statistics) {
+    class LegendreCacheCreator final : public LegendreCache::CacheContentCreator {
+
+        atlas::trans::LegendreCacheCreator& creator_;
+        util::MIRStatistics& statistics_;
+
+        void create(const eckit::PathName& path, LegendreCacheTraits::value_type& /*ignore*/, bool& saved) override {
+            trace::ResourceUsage usage("LegendreBuilder: create Legendre coefficients");
+            auto timing(statistics_.createCoeffTimer());
+
+            // This will create the cache
+            Log::info() << "LegendreBuilder: create Legendre coefficients '" + path + "'" << std::endl;
+            if (subprocess) {
+                creator_.create(path);
+            }
+            else {
+                util::lock_guard<util::recursive_mutex> lock(transMutex());
+                creator_.create(path);
+            }
+
+            saved = path.exists();
+        }
+
+    public:
+        LegendreCacheCreator(atlas::trans::LegendreCacheCreator& creator, util::MIRStatistics& statistics) :
+            creator_(creator), statistics_(statistics) {}
+        ~LegendreCacheCreator() override = default;
+
+        LegendreCacheCreator(const LegendreCacheCreator&)            = delete;
+        LegendreCacheCreator(LegendreCacheCreator&&)                 = delete;
+        LegendreCacheCreator& operator=(const LegendreCacheCreator&) = delete;
+        LegendreCacheCreator& operator=(LegendreCacheCreator&&)      = delete;
+    };
+
+    static LegendreCache cache;
+    LegendreCacheCreator create(creator, statistics);
+
+    int dummy = 0;
+    return cache.getOrCreate(creator.uid(), create, dummy);
+}
+
+
+size_t LegendreBuilder::build(const std::vector<Request>& requests, size_t processes) {
+    ASSERT(processes > 0);
+
+    size_t failed = 0;
+
+    if (processes > 1 && Background::instance().started()) {
+        Log::warning() << "LegendreBuilder: background builds running, building in-process" << std::endl;
+        processes = 1;
+    }
+
+    if (processes == 1) {
+        for (const auto& r : requests) {
+            try {
+                failed += create(r) ? 0 : 1;
+            }
+            catch (std::exception& e) {
+                Log::error() << "LegendreBuilder: build failed for " << r << ": " << e.what() << std::endl;
+                ++failed;
+            }
+        }
+        return failed;
+    }
+
+    // worker processes (concurrent builds of the same coefficients wait on the cache lock)
+    std::map<pid_t, size_t> running;
+
+    auto wait = [&]() {
+        int code = 0;
+        pid_t pid;
+        SYSCALL(pid = ::waitpid(-1, &code, 0));
+
+        auto r = running.find(pid);
+        ASSERT(r != running.end());
+
+        if (!WIFEXITED(code) || WEXITSTATUS(code) != 0) {
+            Log::error() << "LegendreBuilder: build failed for " << requests[r->second] << " (process " << pid
+                         << ", status " << code << ")" << std::endl;
+            ++failed;
+        }
+
+        running.erase(r);
+    };
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        while (running.size() >= processes) {
+            wait();
+        }
+
+        pid_t pid = ::fork();
+        switch (pid) {
+
+            case 0:
+                // child
+                subprocess = true;
+                try {
+                    ::_exit(create(requests[i]) ? 0 : 1);
+                }
+                catch (std::exception& e) {
+                    Log::error() << "LegendreBuilder: build failed for " << requests[i] << ": " << e.what()
+                                 << std::endl;
+                }
+                ::_exit(1);
+
+            case -1:
+                // error
+                Log::error() << "LegendreBuilder: failed to fork(): " << Log::syserr << std::endl;
+                try {
+                    failed += create(requests[i]) ? 0 : 1;
+                }
+                catch (std::exception& e) {
+                    Log::error() << "LegendreBuilder: build failed for " << requests[i] << ": " << e.what()
+                                 << std::endl;
+                    ++failed;
+                }
+                break;
+
+            default:
+                // parent
+                Log::info() << "LegendreBuilder: building " << requests[i] << " in sub-process " << pid << std::endl;
+                running.emplace(pid, i);
+                break;
+        }
+    }
+
+    while (!running.empty()) {
+        wait();
+    }
+
+    return failed;
+}
+
+
+LegendreBuilder::Request LegendreBuilder::request(const std::string& gridTruncation,
+                                                  const param::MIRParametrisation& param) {
+    auto gt = eckit::StringTools::split(":", gridTruncation);
+    if (gt.size() != 2) {
+        throw exception::UserError("LegendreBuilder: expected <grid>:<truncation>, got '" + gridTruncation + "'");
+    }
+
+    // same options as the spectral transforms
+    std::string type = "local";
+    bool flt         = false;
+    param.get("atlas-trans-type", type);
+    param.get("atlas-trans-flt", flt);
+
+    options_t options;
+    options.set(atlas::option::type(type));
+    options.set("flt", flt);
+
+    repres::RepresentationHandle rep(key::grid::Grid::lookup(gt[0]).representation());
+    return {rep->atlasGrid(), eckit::Translator<std::string, int>()(gt[1]), options};
+}
+
+
+void LegendreBuilder::hint(const Request& r) {
+    atlas::trans::LegendreCacheCreator creator(r.grid, r.truncation, r.options);
+    if (creator.supported()) {
+        Background::instance().push(r, creator.uid());
+    }
+}
+
+
+void LegendreBuilder::wait() {
+    Background::instance().wait();
+}
+
+
+util::recursive_mutex& LegendreBuilder::transMutex() {
+    static util::recursive_mutex mutex;
+    return mutex;
+}
+
+
+std::ostream& operator<<(std::ostream& out, const LegendreBuilder::Request& r) {
+    out << "Request[grid=" << r.grid.name() << ",truncation=" << r.truncation << ",options=" << r.options << "]";
+    return out;
+}
+
+
+}  // namespace mir::caching::legendre
@@ -0,0 +1,77 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+
+#include "mir/util/Atlas.h"
+#include "mir/util/Mutex.h"
+
+
+namespace mir {
+namespace param {
+class MIRParametrisation;
+}
+namespace util {
+class MIRStatistics;
+}
+}  // namespace mir
+
+
+namespace mir::caching::legendre {
+
+
+/**
+ * Builds Legendre coefficients (LegendreCache entries) if absent. The cache is file-locked, so concurrent builds of the
+ * same entry (by threads or processes) happen only once, the others wait for it.
+ */
+class LegendreBuilder {
+public:
+    using options_t = atlas::util::Config;
+
+    struct Request {
+        atlas::Grid grid;
+        int truncation = 0;
+        options_t options;
+    };
+
+    /// Path to the coefficients of a creator, built if absent (blocking)
+    static eckit::PathName build(atlas::trans::LegendreCacheCreator&, util::MIRStatistics&);
+
+    /// Build coefficients if absent, in up to a number of worker processes (blocking), returns the number of failures;
+    /// worker processes are forked, so this is for single-threaded callers (in-process if background builds are running)
+    static size_t build(const std::vector<Request>&, size_t processes);
+
+    /// Build coefficients if absent in the background, one at a time in a thread (non-blocking, although building
+    /// transforms waits for the transforms lock while coefficients are created)
+    static void hint(const Request&);
+
+    /// Request from "<grid>:<truncation>" (for example O1280:1279), with the spectral transforms options
+    static Request request(const std::string& gridTruncation, const param::MIRParametrisation&);
+
+    /// Wait for the background builds
+    static void wait();
+
+    /// Building and destroying transforms (including FFT planning) is not thread-safe
+    static util::recursive_mutex& transMutex();
+};
+
+
+std::ostream& operator<<(std::ostream&, const LegendreBuilder::Request&);
+
+
+}  // namespace mir::caching::legendre
@@ -12,9 +12,13 @@
 
 #include "mir/caching/matrix/FileLoader.h"
 
+#include <memory>
 #include <ostream>
 
-#include "mir/method/WeightMatrix.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/DataHandle.h"
+
+#include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
 #include "mir/util/Types.h"
 
@@ -27,9 +31,12 @@ FileLoader::FileLoader(const std::string& name, const eckit::PathName& path) :
 
     Log::debug() << "Loading matrix from " << path << std::endl;
 
-    // Note: buffer size is based on file.size() -- which is assumed to be bigger than the memory footprint
-    method::WeightMatrix w(path);
-    w.dump(buffer_);
+    // matrix file holds the in-memory layout (see WeightMatrix::save)
+    std::unique_ptr<eckit::DataHandle> dh(path.fileHandle());
+    dh->openForRead();
+    auto c = eckit::closer(*dh);
+
+    ASSERT(dh->read(buffer_, long(buffer_.size())) == long(buffer_.size()));
 }
 
 FileLoader::~FileLoader() = default;
@@ -24,16 +24,18 @@
 
 #include <cerrno>
 #include <cstring>
+#include <memory>
 #include <sstream>
 
 // #include "eckit/config/Resource.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/DataHandle.h"
 #include "eckit/maths/Functions.h"
 #include "eckit/memory/Padded.h"
 #include "eckit/memory/Shmget.h"
 // #include "eckit/os/SemLocker.h"
 #include "eckit/runtime/Main.h"
 
-#include "mir/method/WeightMatrix.h"
 #include "mir/util/Error.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
@@ -142,8 +144,7 @@ SharedMemoryLoader::SharedMemoryLoader(const std::string& name, const eckit::Pat
         throw exception::FailedSystemCall(msg.str());
     }
 
-    // NOTE: size is based on file.size() which is assumed to be bigger than the memory footprint. Real size would be:
-    // size_t sz = sizeof(SHMInfo) + w.footprint();
+    // NOTE: matrix file holds the in-memory layout (see WeightMatrix::save), loaded as-is after the info record
 
     size_t sz      = size_t(path.size()) + sizeof(SHMInfo);
     long page_size = ::sysconf(_SC_PAGESIZE);
@@ -222,8 +223,13 @@ SharedMemoryLoader::SharedMemoryLoader(const std::string& name, const eckit::Pat
         }
         else {
 
-            method::WeightMatrix w(path);
-            w.dump(addr + sizeof(SHMInfo), size());
+            std::unique_ptr<eckit::DataHandle> dh(path.fileHandle());
+            dh->openForRead();
+            auto c = eckit::closer(*dh);
+
+            const auto length = long(path.size());
+            ASSERT(size_t(length) <= size());
+            ASSERT(dh->read(addr + sizeof(SHMInfo), length) == length);
 
             // Set info record for checks
             nfo->magic = MAGIC;
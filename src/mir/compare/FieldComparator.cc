@@ -458,13 +458,11 @@ void FieldComparator::json(eckit::JSON& json, const std::string& path) {
 }
 
 
-static eckit::AutoStdFile& open(const std::string& path) {
-    auto j = cache_.find(path);
-    if (j == cache_.end()) {
-        cache_.insert(path, new eckit::AutoStdFile(path));
-        j = cache_.find(path);
+static std::shared_ptr<eckit::AutoStdFile> open(const std::string& path) {
+    if (auto j = cache_.find(path); j) {
+        return j;
     }
-    return *j;
+    return cache_.insert(path, new eckit::AutoStdFile(path));
 }
 
 
@@ -492,7 +490,9 @@ struct Statistics {
 static void getStats(const Field& field, Statistics& stats) {
     eckit::Buffer buffer(bufferSize);
 
-    eckit::AutoStdFile& f = open(field.path());
+    auto file = open(field.path());  // in use (not purged)
+
+    eckit::AutoStdFile& f = *file;
     size_t size           = buffer.size();
     SYSCALL(fseek(f, field.offset(), SEEK_SET));
     GRIB_CALL(wmo_read_any_from_file(f, buffer, &size));
@@ -557,9 +557,6 @@ static void getStats(const Field& field, Statistics& stats) {
 void FieldComparator::compareFieldStatistics(const MultiFile& multi1, const MultiFile& multi2, const Field& field1,
                                              const Field& field2) {
 
-    caching::InMemoryCacheStatistics ignore;
-    caching::InMemoryCacheUser<eckit::AutoStdFile> lock(cache_, ignore);
-
     Statistics s1;
     getStats(field1, s1);
 
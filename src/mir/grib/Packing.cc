@@ -12,9 +12,15 @@
 
 #include "mir/grib/Packing.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <ostream>
 
+#include "eckit/config/Resource.h"
 #include "eckit/filesystem/PathName.h"
 
 #include "mir/config/LibMir.h"
@@ -26,6 +32,7 @@
 #include "mir/util/Exceptions.h"
 #include "mir/util/Grib.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 
 
 namespace mir::grib {
@@ -121,6 +128,215 @@ bool Packing::empty() const {
 }
 
 
+long Packing::parallelBitsPerValue(grib_handle* input, const grib_info& info, size_t numberOfValues,
+                                   bool hasMissing) const {
+    // minimum number of values (0 to disable)
+    static size_t minimum = eckit::Resource<size_t>("$MIR_GRIB_PARALLEL_PACKING", 0);
+    if (minimum == 0 || numberOfValues < minimum || hasMissing || !gridSimple(input)) {
+        return 0;
+    }
+
+    long edition = info.packing.editionNumber;
+    if (edition == 0) {
+        GRIB_CALL(codes_get_long(input, "edition", &edition));
+    }
+
+    long bits = info.packing.bitsPerValue;
+    if (info.packing.accuracy != CODES_UTIL_ACCURACY_USE_PROVIDED_BITS_PER_VALUES) {
+        GRIB_CALL(codes_get_long(input, "bitsPerValue", &bits));
+    }
+
+    return edition == 2 && 0 < bits && bits <= 32 ? bits : 0;
+}
+
+
+namespace {
+
+
+std::uint64_t get_unsigned(const unsigned char* p, size_t n) {
+    std::uint64_t value = 0;
+    for (size_t i = 0; i < n; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+
+void set_unsigned(unsigned char* p, std::uint64_t value, size_t n) {
+    for (size_t i = n; i > 0; --i, value >>= 8) {
+        p[i - 1] = static_cast<unsigned char>(value & 0xff);
+    }
+}
+
+
+long get_signed16(const unsigned char* p) {
+    auto value = long(get_unsigned(p, 2) & 0x7fff);
+    return (p[0] & 0x80) != 0 ? -value : value;
+}
+
+
+void set_signed16(unsigned char* p, long value) {
+    ASSERT(std::abs(value) <= 0x7fff);
+    set_unsigned(p, std::uint64_t(std::abs(value)) | (value < 0 ? 0x8000 : 0), 2);
+}
+
+
+/// Binary scale factor packing a range with a number of bits (as ecCodes' grib_get_binary_scale_fact)
+long binary_scale_factor(double max, double min, long bits) {
+    const std::uint64_t maxint = (std::uint64_t(1) << bits) - 1;
+    const auto dmaxint         = double(maxint);
+
+    const double range = max - min;
+    ASSERT(range > 0);
+
+    double zs  = 1;
+    long scale = 0;
+    while (range * zs <= dmaxint) {
+        scale--;
+        zs *= 2;
+    }
+    while (range * zs > dmaxint) {
+        scale++;
+        zs /= 2;
+    }
+    while (std::uint64_t(range * zs + 0.5) <= maxint) {
+        scale--;
+        zs *= 2;
+    }
+    while (std::uint64_t(range * zs + 0.5) > maxint) {
+        scale++;
+        zs /= 2;
+    }
+    return scale;
+}
+
+
+}  // namespace
+
+
+bool Packing::packSimple(std::vector<char>& message, long bitsPerValue, const std::vector<double>& values,
+                         size_t threads) {
+    ASSERT(0 < bitsPerValue && bitsPerValue <= 32);
+    const auto bits = size_t(bitsPerValue);
+    const auto n    = values.size();
+
+    // GRIB2 message, single field, sections 5 (template 5.0), 6 (no bitmap) and 7 (last)
+    const auto* p   = reinterpret_cast<const unsigned char*>(message.data());
+    const auto size = message.size();
+    if (size < 16 + 4 || std::memcmp(p, "GRIB", 4) != 0 || p[7] != 2 || get_unsigned(p + 8, 8) != size ||
+        std::memcmp(p + size - 4, "7777", 4) != 0) {
+        return false;
+    }
+
+    size_t s5 = 0;
+    size_t s6 = 0;
+    size_t s7 = 0;
+    for (size_t o = 16, len = 0; o < size - 4; o += len) {
+        len = get_unsigned(p + o, 4);
+        if (len < 5 || o + len > size - 4) {
+            return false;
+        }
+
+        auto* s = p[o + 4] == 5 ? &s5 : p[o + 4] == 6 ? &s6 : p[o + 4] == 7 ? &s7 : nullptr;
+        if (s != nullptr) {
+            if (*s != 0) {
+                return false;
+            }
+            *s = o;
+        }
+    }
+
+    if (s5 == 0 || s6 == 0 || s7 == 0 || s7 + get_unsigned(p + s7, 4) != size - 4 ||
+        get_unsigned(p + s5, 4) != 21 || get_unsigned(p + s5 + 5, 4) != n || get_unsigned(p + s5 + 9, 2) != 0 ||
+        p[s6 + 5] != 255) {
+        return false;
+    }
+
+    const auto bytes = (n * bits + 7) / 8;
+    if (5 + bytes > std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+
+
+    // Reference value and scale factors (as ecCodes)
+    const double decimal = std::pow(10., double(get_signed16(p + s5 + 17)));
+
+    const auto groups = (n + 7) / 8;  // groups of 8 values start on a byte boundary
+    const auto ranges = util::parallel_ranges(groups, threads);
+
+    std::vector<std::pair<double, double>> minmax(ranges.size());
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        auto mm = std::minmax_element(values.begin() + long(8 * begin), values.begin() + long(std::min(n, 8 * end)));
+        minmax[r] = {*mm.first, *mm.second};
+    });
+
+    auto min = minmax.front().first;
+    auto max = minmax.front().second;
+    for (const auto& mm : minmax) {
+        min = std::min(min, mm.first);
+        max = std::max(max, mm.second);
+    }
+
+    min *= decimal;
+    max *= decimal;
+    if (!(min < max)) {
+        return false;
+    }
+
+    auto reference = float(min);
+    if (double(reference) > min) {
+        reference = std::nextafter(reference, -std::numeric_limits<float>::infinity());
+    }
+
+    const auto E       = binary_scale_factor(max, reference, bitsPerValue);
+    const auto divisor = std::ldexp(1., int(-E));
+
+
+    // Message (header up to section 7, then section 7 packed in parallel and section 8)
+    std::vector<char> result(s7 + 5 + bytes + 4);
+    std::memcpy(result.data(), p, s7);
+
+    auto* q = reinterpret_cast<unsigned char*>(result.data());
+    set_unsigned(q + 8, result.size(), 8);
+
+    std::uint32_t R = 0;
+    static_assert(sizeof(R) == sizeof(reference), "float is IEEE 32-bit");
+    std::memcpy(&R, &reference, sizeof(R));
+    set_unsigned(q + s5 + 11, R, 4);
+    set_signed16(q + s5 + 15, E);
+    q[s5 + 19] = static_cast<unsigned char>(bits);
+    q[s5 + 20] = 0;
+
+    set_unsigned(q + s7, 5 + bytes, 4);
+    q[s7 + 4] = 7;
+
+    auto* data = q + s7 + 5;
+    util::parallel_for(ranges, [&](size_t, size_t begin, size_t end) {
+        auto* out = data + begin * bits;
+
+        std::uint64_t acc = 0;
+        size_t count      = 0;
+        for (size_t i = 8 * begin; i < std::min(n, 8 * end); ++i) {
+            auto x = std::uint64_t(((values[i] * decimal - double(reference)) * divisor) + 0.5);
+            acc    = (acc << bits) | x;
+            for (count += bits; count >= 8;) {
+                count -= 8;
+                *out++ = static_cast<unsigned char>((acc >> count) & 0xff);
+            }
+        }
+
+        if (count > 0) {
+            *out = static_cast<unsigned char>((acc << (8 - count)) & 0xff);
+        }
+    });
+
+    std::memcpy(q + result.size() - 4, "7777", 4);
+
+    message.swap(result);
+    return true;
+}
+
+
 void Packing::fill(grib_info& info, long pack) const {
     info.packing.packing  = CODES_UTIL_PACKING_SAME_AS_INPUT;
     info.packing.accuracy = CODES_UTIL_ACCURACY_SAME_BITS_PER_VALUES_AS_INPUT;
@@ -184,6 +400,13 @@ struct ArchivedValue : Packing {
     }
 
     void set(const repres::Representation*, grib_handle* handle) const override { Packing::set(handle, ""); }
+
+    bool gridSimple(grib_handle* input) const override {
+        char type[64];
+        size_t len = sizeof(type);
+        return codes_get_string(input, "packingType", type, &len) == CODES_SUCCESS &&
+               std::string(type) == "grid_simple";
+    }
 };
 
 
@@ -258,6 +481,8 @@ struct Simple : Packing {
     void set(const repres::Representation*, grib_handle* handle) const override {
         Packing::set(handle, gridded() ? "grid_simple" : "spectral_simple");
     }
+
+    bool gridSimple(grib_handle* /*input*/) const override { return gridded(); }
 };
 
 
@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 
 struct grib_info;
@@ -68,6 +69,10 @@ public:
     bool printParametrisation(std::ostream&) const;
     bool empty() const;
 
+    /// Bits per value if values are packed by MIR (grid_simple, GRIB2, for large fields without missing values), 0
+    /// otherwise
+    long parallelBitsPerValue(grib_handle* input, const grib_info&, size_t numberOfValues, bool hasMissing) const;
+
     // -- Overridden methods
     // None
 
@@ -79,6 +84,11 @@ public:
     static Packing* build(const param::MIRParametrisation&);
     static void list(std::ostream&);
 
+    /// Pack values (grid_simple) in parallel into a GRIB2 message encoded for a constant field, as ecCodes would
+    /// (reference value, binary and decimal scale factors), returns false if the message is not supported
+    static bool packSimple(std::vector<char>& message, long bitsPerValue, const std::vector<double>& values,
+                           size_t threads);
+
 protected:
     // -- Members
 
@@ -99,6 +109,9 @@ protected:
     void fill(grib_info&, long) const;
     void set(grib_handle*, const std::string&) const;
 
+    /// If output values are packed with grid_simple
+    virtual bool gridSimple(grib_handle* /*input*/) const { return false; }
+
     // -- Overridden methods
     // None
 
@@ -27,6 +27,7 @@ GribFileInput::GribFileInput(const eckit::PathName& path, off_t offset) :
 GribFileInput::GribFileInput(const eckit::PathName& path) : path_(path), handle_(nullptr) {}
 
 GribFileInput::~GribFileInput() {
+    stopReadAhead();
     if (handle_ != nullptr) {
         handle_->close();
         delete handle_;
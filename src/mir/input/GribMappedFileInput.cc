@@ -0,0 +1,245 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/input/GribMappedFileInput.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "eckit/config/Resource.h"
+#include "eckit/io/StdFile.h"
+#include "eckit/memory/MMap.h"
+#include "eckit/os/Stat.h"
+
+#include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::input {
+
+
+static constexpr char INDEX_MAGIC[]   = "MIRINDEX";
+static constexpr size_t INDEX_VERSION = 1;
+
+
+static bool persistIndex() {
+    static bool persist = eckit::Resource<bool>("$MIR_GRIB_INPUT_INDEX", false);
+    return persist;
+}
+
+
+/// GRIB message length from section 0, or from ecCodes for large GRIB1 messages
+static size_t message_length(const unsigned char* p, size_t size) {
+    if (auto len = grib_message_length(p, size); len > 0) {
+        return len;
+    }
+
+    if (size >= 16 && p[7] == 1) {
+        // large GRIB1 messages encode their length elsewhere
+        std::unique_ptr<grib_handle, decltype(&codes_handle_delete)> h(
+            codes_handle_new_from_message(nullptr, const_cast<unsigned char*>(p), size), &codes_handle_delete);
+        ASSERT(h);
+
+        long total = 0;
+        GRIB_CALL(codes_get_long(h.get(), "totalLength", &total));
+        return total > 0 ? size_t(total) : 0;
+    }
+
+    return 0;
+}
+
+
+GribMappedFileInput::GribMappedFileInput(const eckit::PathName& path) :
+    path_(path), fd_(-1), address_(nullptr), size_(0), modified_(0), current_(0) {
+
+    fd_ = ::open(path.localPath(), O_RDONLY);
+    if (fd_ < 0) {
+        Log::error() << "open(" << path << ')' << Log::syserr << std::endl;
+        throw exception::FailedSystemCall("open");
+    }
+
+    eckit::Stat::Struct s;
+    SYSCALL(eckit::Stat::stat(path.localPath(), &s));
+
+    size_     = size_t(s.st_size);
+    modified_ = static_cast<long long>(s.st_mtime);
+
+    if (size_ > 0) {
+        address_ = eckit::MMap::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (address_ == MAP_FAILED) {
+            address_ = nullptr;
+            Log::error() << "mmap(" << path << ',' << size_ << ')' << Log::syserr << std::endl;
+            throw exception::FailedSystemCall("mmap");
+        }
+    }
+
+    const eckit::PathName index(path_ + ".mirindex");
+    if (!persistIndex() || !load(index)) {
+        scan();
+        if (persistIndex()) {
+            save(index);
+        }
+    }
+
+    Log::debug() << *this << std::endl;
+}
+
+
+GribMappedFileInput::~GribMappedFileInput() {
+    // handle refers to the mapped memory
+    handle(nullptr);
+
+    if (address_ != nullptr) {
+        SYSCALL(eckit::MMap::munmap(address_, size_));
+    }
+    if (fd_ >= 0) {
+        SYSCALL(::close(fd_));
+    }
+}
+
+
+void GribMappedFileInput::scan() {
+    index_.clear();
+
+    const auto* begin = static_cast<const unsigned char*>(address_);
+    const auto* end   = begin + size_;
+    const unsigned char magic[] = {'G', 'R', 'I', 'B'};
+
+    for (const auto* p = begin; (p = std::search(p, end, magic, magic + 4)) != end;) {
+        auto len = message_length(p, size_t(end - p));
+
+        if (len < 16 || len > size_t(end - p) || std::memcmp(p + len - 4, "7777", 4) != 0) {
+            std::ostringstream msg;
+            msg << "GribMappedFileInput: invalid message in '" << path_ << "' at offset " << (p - begin);
+            throw exception::SeriousBug(msg.str());
+        }
+
+        index_.push_back({std::uint64_t(p - begin), std::uint64_t(len)});
+        p += len;
+    }
+}
+
+
+bool GribMappedFileInput::load(const eckit::PathName& path) {
+    if (!path.exists()) {
+        return false;
+    }
+
+    // index for the same file size and modification time
+    eckit::AutoStdFile f(path);
+
+    char magic[8];
+    std::uint64_t header[4];  // version, file size, modification time, number of messages
+    if (std::fread(magic, sizeof(magic), 1, f) != 1 || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+        std::fread(header, sizeof(header), 1, f) != 1 || header[0] != INDEX_VERSION || header[1] != size_ ||
+        header[2] != std::uint64_t(modified_)) {
+        Log::debug() << "GribMappedFileInput: ignoring outdated index '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::vector<Entry> index(header[3]);
+    if (!index.empty() && std::fread(index.data(), sizeof(Entry), index.size(), f) != index.size()) {
+        Log::debug() << "GribMappedFileInput: ignoring truncated index '" << path << "'" << std::endl;
+        return false;
+    }
+
+    for (const auto& e : index) {
+        if (e.offset + e.length > size_) {
+            Log::debug() << "GribMappedFileInput: ignoring invalid index '" << path << "'" << std::endl;
+            return false;
+        }
+    }
+
+    index_.swap(index);
+    return true;
+}
+
+
+void GribMappedFileInput::save(const eckit::PathName& path) const {
+    // the index is optional, so failing to save it is not an error
+    try {
+        auto tmp = eckit::PathName::unique(path);
+        {
+            eckit::AutoStdFile f(tmp, "w");
+
+            std::uint64_t header[4] = {INDEX_VERSION, size_, std::uint64_t(modified_), index_.size()};
+            if (std::fwrite(INDEX_MAGIC, 8, 1, f) != 1 || std::fwrite(header, sizeof(header), 1, f) != 1 ||
+                (!index_.empty() && std::fwrite(index_.data(), sizeof(Entry), index_.size(), f) != index_.size())) {
+                throw exception::WriteError("GribMappedFileInput: cannot write '" + tmp + "'");
+            }
+        }
+
+        eckit::PathName::rename(tmp, path);
+        Log::debug() << "GribMappedFileInput: created index '" << path << "'" << std::endl;
+    }
+    catch (std::exception& e) {
+        Log::warning() << "GribMappedFileInput: cannot save index '" << path << "': " << e.what() << std::endl;
+    }
+}
+
+
+size_t GribMappedFileInput::messages() const {
+    return index_.size();
+}
+
+
+const void* GribMappedFileInput::message(size_t which, size_t& length) const {
+    ASSERT(which < index_.size());
+    length = size_t(index_[which].length);
+    return static_cast<const char*>(address_) + index_[which].offset;
+}
+
+
+bool GribMappedFileInput::seek(size_t which) {
+    handle(nullptr);
+
+    if (which >= index_.size()) {
+        current_ = index_.size();
+        return false;
+    }
+
+    size_t length       = 0;
+    const void* address = message(which, length);
+
+    current_ = which + 1;
+    ASSERT(handle(codes_handle_new_from_message(nullptr, const_cast<void*>(address), length)));
+    return true;
+}
+
+
+bool GribMappedFileInput::next() {
+    return seek(current_);
+}
+
+
+bool GribMappedFileInput::sameAs(const MIRInput& other) const {
+    const auto* o = dynamic_cast<const GribMappedFileInput*>(&other);
+    return (o != nullptr) && (path_ == o->path_);
+}
+
+
+void GribMappedFileInput::print(std::ostream& out) const {
+    out << "GribMappedFileInput[path=" << path_ << ",size=" << Log::Bytes(size_) << ",messages=" << index_.size()
+        << "]";
+}
+
+
+}  // namespace mir::input
@@ -0,0 +1,129 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+
+#include "mir/input/GribInput.h"
+
+
+namespace mir::input {
+
+
+/**
+ * GRIB file input, memory-mapped and indexed (message offsets and lengths) on construction, so messages are handed to
+ * ecCodes without copies and are accessible at random (also concurrently, read-only). The index is optionally
+ * persisted next to the file ($MIR_GRIB_INPUT_INDEX), and reused while the file is unchanged.
+ */
+class GribMappedFileInput : public GribInput {
+public:
+    // -- Exceptions
+    // None
+
+    // -- Constructors
+
+    explicit GribMappedFileInput(const eckit::PathName&);
+
+    // -- Destructor
+
+    ~GribMappedFileInput() override;
+
+    // -- Convertors
+    // None
+
+    // -- Operators
+    // None
+
+    // -- Methods
+
+    /// Number of messages
+    size_t messages() const;
+
+    /// Message address (valid for the input lifetime) and length
+    const void* message(size_t which, size_t& length) const;
+
+    /// Position on a message (then next() continues from the following one), returns false if out of range
+    bool seek(size_t which);
+
+    // -- Overridden methods
+
+    bool next() override;
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+protected:
+    // -- Members
+    // None
+
+    // -- Methods
+    // None
+
+    // -- Overridden methods
+    // None
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+private:
+    // -- Types
+
+    struct Entry {
+        std::uint64_t offset;
+        std::uint64_t length;
+    };
+
+    // -- Members
+
+    eckit::PathName path_;
+    int fd_;
+    void* address_;
+    size_t size_;
+    long long modified_;
+
+    std::vector<Entry> index_;
+    size_t current_;
+
+    // -- Methods
+
+    void scan();
+    bool load(const eckit::PathName&);
+    void save(const eckit::PathName&) const;
+
+    // -- Overridden methods
+
+    // From MIRInput
+    void print(std::ostream&) const override;
+    bool sameAs(const MIRInput&) const override;
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+    // -- Friends
+    // None
+};
+
+
+}  // namespace mir::input
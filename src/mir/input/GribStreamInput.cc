@@ -12,6 +12,15 @@
 
 #include "mir/input/GribStreamInput.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
 #include "eckit/config/Resource.h"
 #include "eckit/io/DataHandle.h"
 
@@ -30,14 +39,243 @@ static size_t buffer_size() {
 }
 
 
-static long readcb(void* data, void* buffer, long len) {
-    auto* handle = reinterpret_cast<eckit::DataHandle*>(data);
-    long l       = handle->read(buffer, len);
-    // ecCodes only interprets a -1 as EOF
-    return l == 0 ? -1 : l;
+static size_t read_ahead() {
+    static size_t messages = eckit::Resource<size_t>("$MIR_GRIB_INPUT_READ_AHEAD", 0);
+    return messages;
 }
 
 
+/// Data handle reader, able to skip GRIB messages by their (section 0) length without reading them
+class GribStreamInput::Reader {
+    static constexpr size_t HEADER = 16;
+
+    eckit::DataHandle& handle_;
+    unsigned char header_[HEADER];
+    size_t begin_ = 0;  // bytes [begin, end) of the header are read, but not consumed
+    size_t end_   = 0;
+
+    static long readcb(void* data, void* buffer, long len) {
+        auto* reader = reinterpret_cast<Reader*>(data);
+        if (reader->begin_ < reader->end_) {
+            auto l = std::min(static_cast<size_t>(len), reader->end_ - reader->begin_);
+            std::memcpy(buffer, reader->header_ + reader->begin_, l);
+            reader->begin_ += l;
+            return static_cast<long>(l);
+        }
+
+        long l = reader->handle_.read(buffer, len);
+        // ecCodes only interprets a -1 as EOF
+        return l == 0 ? -1 : l;
+    }
+
+    /// Read the next message header, returning the message length (0 if unknown, or at EOF)
+    size_t header() {
+        if (begin_ > 0) {
+            std::memmove(header_, header_ + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+
+        for (long l = 0; end_ < HEADER; end_ += static_cast<size_t>(l)) {
+            if ((l = handle_.read(header_ + end_, static_cast<long>(HEADER - end_))) <= 0) {
+                return 0;
+            }
+        }
+
+        return grib_message_length(header_, HEADER);
+    }
+
+    /// Message of a known length, as wmo_read_any_from_stream: not larger than the buffer size, ending in "7777"
+    static void check_length(size_t len) {
+        if (len > buffer_size()) {
+            Log::debug() << "GribStreamInput::next() message is " << len << " bytes (" << Log::Bytes(len)
+                         << "), rerun with:" << std::endl;
+            Log::debug() << "env MIR_GRIB_INPUT_BUFFER_SIZE=" << len << std::endl;
+            GRIB_ERROR(CODES_BUFFER_TOO_SMALL, "GribStreamInput::Reader");
+        }
+    }
+
+    static void check_end(const void* end) {
+        if (std::memcmp(end, "7777", 4) != 0) {
+            GRIB_ERROR(CODES_7777_NOT_FOUND, "GribStreamInput::Reader");
+        }
+    }
+
+    /// Read exactly len bytes
+    void read_fully(void* buffer, size_t len) {
+        for (size_t i = 0; i < len;) {
+            long l = handle_.read(static_cast<char*>(buffer) + i, static_cast<long>(len - i));
+            if (l <= 0) {
+                GRIB_ERROR(CODES_PREMATURE_END_OF_FILE, "GribStreamInput::Reader");
+            }
+            i += static_cast<size_t>(l);
+        }
+    }
+
+public:
+    explicit Reader(eckit::DataHandle& handle) : handle_(handle) {}
+
+    /// Read the next message into a buffer, as ecCodes' wmo_read_any_from_stream
+    int read(eckit::Buffer& buffer, size_t& len) {
+        len = buffer.size();
+        return wmo_read_any_from_stream(this, &readcb, buffer, &len);
+    }
+
+    /// Read the next message into a buffer of its size (null at EOF)
+    std::unique_ptr<eckit::Buffer> read(size_t& len) {
+        len = header();
+        if (len < HEADER + 4) {
+            std::unique_ptr<eckit::Buffer> buffer(new eckit::Buffer(buffer_size()));
+            int e = read(*buffer, len);
+            if (e == CODES_END_OF_FILE) {
+                return nullptr;
+            }
+
+            if (e != CODES_SUCCESS) {
+                GRIB_ERROR(e, "wmo_read_any_from_stream");
+            }
+            return buffer;
+        }
+
+        check_length(len);
+
+        std::unique_ptr<eckit::Buffer> buffer(new eckit::Buffer(len));
+        std::memcpy(*buffer, header_, HEADER);
+        begin_ = end_ = 0;
+
+        auto* data = static_cast<char*>(*buffer);
+        read_fully(data + HEADER, len - HEADER);
+        check_end(data + len - 4);
+
+        return buffer;
+    }
+
+    /// Skip the next message, returns false at EOF
+    bool skip() {
+        if (auto len = header(); len >= HEADER + 4) {
+            check_length(len);
+            begin_ = end_ = 0;
+            handle_.skip(static_cast<off_t>(len - HEADER - 4));
+
+            char end[4];
+            read_fully(end, 4);
+            check_end(end);
+            return true;
+        }
+
+        // not a GRIB message with a known length, so read it
+        eckit::Buffer buffer(buffer_size());
+        size_t len = 0;
+        int e      = read(buffer, len);
+        if (e == CODES_END_OF_FILE) {
+            return false;
+        }
+
+        if (e == CODES_BUFFER_TOO_SMALL) {
+            Log::debug() << "GribStreamInput::next() message is " << len << " bytes (" << Log::Bytes(len) << ")"
+                         << std::endl;
+            GRIB_ERROR(e, "wmo_read_any_from_stream");
+        }
+
+        if (e != CODES_SUCCESS) {
+            GRIB_ERROR(e, "wmo_read_any_from_stream");
+        }
+        return true;
+    }
+};
+
+
+/// Messages read by a background thread, into a bounded queue (so reading overlaps processing)
+class GribStreamInput::ReadAhead {
+    Reader& reader_;
+    const size_t step_;
+    const size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::pair<std::unique_ptr<eckit::Buffer>, size_t>> queue_;
+    std::exception_ptr error_;
+    bool end_  = false;
+    bool stop_ = false;
+    std::thread thread_;
+
+    void worker() {
+        try {
+            for (bool first = true;; first = false) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cond_.wait(lock, [&] { return queue_.size() < capacity_ || stop_; });
+                    if (stop_) {
+                        return;
+                    }
+                }
+
+                bool more = true;
+                for (size_t i = 1; more && !first && i < step_; ++i) {
+                    more = reader_.skip();
+                }
+
+                size_t len = 0;
+                std::unique_ptr<eckit::Buffer> buffer(more ? reader_.read(len) : nullptr);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!buffer) {
+                    end_ = true;
+                    cond_.notify_all();
+                    return;
+                }
+
+                queue_.emplace_back(std::move(buffer), len);
+                cond_.notify_all();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            cond_.notify_all();
+        }
+    }
+
+public:
+    ReadAhead(Reader& reader, size_t step, size_t capacity) :
+        reader_(reader), step_(step), capacity_(capacity), thread_(&ReadAhead::worker, this) {}
+
+    ~ReadAhead() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            cond_.notify_all();
+        }
+        thread_.join();
+    }
+
+    ReadAhead(const ReadAhead&)            = delete;
+    ReadAhead(ReadAhead&&)                 = delete;
+    ReadAhead& operator=(const ReadAhead&) = delete;
+    ReadAhead& operator=(ReadAhead&&)      = delete;
+
+    /// Next message (null at EOF), errors are rethrown after the messages read before them
+    std::unique_ptr<eckit::Buffer> pop(size_t& len) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [&] { return !queue_.empty() || end_ || error_; });
+
+        if (queue_.empty()) {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            return nullptr;
+        }
+
+        auto buffer = std::move(queue_.front().first);
+        len         = queue_.front().second;
+        queue_.pop_front();
+        cond_.notify_all();
+
+        return buffer;
+    }
+};
+
+
 GribStreamInput::GribStreamInput(size_t skip, size_t step) :
     skip_(skip), step_(step), offset_(0), buffer_(buffer_size()), first_(true) {
     ASSERT(step_ > 0);
@@ -55,14 +293,23 @@ GribStreamInput::GribStreamInput() : skip_(0), step_(1), offset_(0), buffer_(buf
 }
 
 
-GribStreamInput::~GribStreamInput() = default;
+GribStreamInput::~GribStreamInput() {
+    stopReadAhead();
+    handle(nullptr);
+}
+
+
+void GribStreamInput::stopReadAhead() {
+    readAhead_.reset();
+}
 
 
 bool GribStreamInput::next() {
 
     handle(nullptr);
+    message_.reset();
 
-    // Skip a few message if needed
+    // Skip a few message if needed (without reading them, if possible)
     size_t advance = step_ - 1;
 
     if (first_) {
@@ -72,28 +319,43 @@ bool GribStreamInput::next() {
         if (offset_ != 0) {
             dataHandle().skip(offset_);
         }
+
+        reader_.reset(new Reader(dataHandle()));
+
+        for (size_t i = 0; i < advance; i++) {
+            if (!reader_->skip()) {
+                return false;
+            }
+        }
+
+        if (read_ahead() > 0) {
+            readAhead_.reset(new ReadAhead(*reader_, step_, read_ahead()));
+        }
+
+        advance = 0;
     }
 
-    for (size_t i = 0; i < advance; i++) {
-        size_t len = buffer_.size();
-        int e      = wmo_read_any_from_stream(&dataHandle(), &readcb, buffer_, &len);
-        if (e == CODES_END_OF_FILE) {
+    if (readAhead_) {
+        // handle refers to the message buffer, kept until the next message
+        size_t len = 0;
+        message_   = readAhead_->pop(len);
+        if (!message_) {
             return false;
         }
 
-        if (e == CODES_BUFFER_TOO_SMALL) {
-            Log::debug() << "GribStreamInput::next() message is " << len << " bytes (" << Log::Bytes(len) << ")"
-                         << std::endl;
-            GRIB_ERROR(e, "wmo_read_any_from_stream");
-        }
+        ASSERT(handle(codes_handle_new_from_message(nullptr, *message_, len)));
+        return true;
+    }
 
-        if (e != CODES_SUCCESS) {
-            GRIB_ERROR(e, "wmo_read_any_from_stream");
+    ASSERT(reader_);
+    for (size_t i = 0; i < advance; i++) {
+        if (!reader_->skip()) {
+            return false;
         }
     }
 
-    size_t len = buffer_.size();
-    int e      = wmo_read_any_from_stream(&dataHandle(), &readcb, buffer_, &len);
+    size_t len = 0;
+    int e      = reader_->read(buffer_, len);
 
     if (e == CODES_SUCCESS) {
         ASSERT(handle(codes_handle_new_from_message(nullptr, buffer_, len)));
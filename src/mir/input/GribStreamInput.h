@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "eckit/io/Buffer.h"
 
 #include "mir/input/GribInput.h"
@@ -66,7 +68,9 @@ protected:
     off_t offset_;
 
     // -- Methods
-    // None
+
+    /// Stop reading ahead, before the data handle is closed (by derived classes' destructors)
+    void stopReadAhead();
 
     // -- Overridden methods
     // None
@@ -78,11 +82,19 @@ protected:
     // None
 
 private:
+    // -- Types
+
+    class Reader;
+    class ReadAhead;
+
     // -- Members
 
     eckit::Buffer buffer_;
     bool first_;
 
+    std::unique_ptr<Reader> reader_;
+    std::unique_ptr<ReadAhead> readAhead_;
+    std::unique_ptr<eckit::Buffer> message_;  // read ahead, in use by the current handle
 
     // -- Methods
 
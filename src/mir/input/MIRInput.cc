@@ -21,6 +21,7 @@
 
 #include "mir/input/ArtificialInput.h"
 #include "mir/input/GribFileInput.h"
+#include "mir/input/GribMappedFileInput.h"
 #include "mir/input/MultiDimensionalGribFileInput.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Grib.h"
@@ -177,6 +178,12 @@ MIRInput* MIRInputFactory::build(const std::string& path, const param::MIRParame
         return aux(new MultiDimensionalGribFileInput(path, N), map);
     }
 
+    // Special case: memory-mapped (GRIB) input
+    auto mapped = map.find("mapped");
+    if (mapped != map.end() && mapped->second.isBool() && mapped->second.as<bool>()) {
+        return aux(new GribMappedFileInput(path), map);
+    }
+
     eckit::AutoStdFile f(path);
     unsigned long magic    = 0;
     unsigned char smagic[] = "????";
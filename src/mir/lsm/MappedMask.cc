@@ -15,13 +15,12 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
-#include <memory>
 
 #include "eckit/memory/MMap.h"
 #include "eckit/os/Stat.h"
 #include "eckit/utils/MD5.h"
 
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
@@ -114,14 +113,16 @@ MappedMask::MappedMask(const std::string& name, const eckit::PathName& path,
     trace::Timer timer("Extract points from  LSM");
 
     // NOTE: this is not using 3D coordinate systems
-    // mask_.reserve(grid.size());
 
     const unsigned char* mask = reinterpret_cast<unsigned char*>(address);
 
-    for (const std::unique_ptr<repres::Iterator> it(representation.iterator()); it->next();) {
-        const auto& p = it->pointUnrotated();
-        Latitude lat  = p.lat();
-        Longitude lon = p.lon().normalise(Longitude::GREENWICH);
+    repres::Coordinates coord;
+    representation.coordinates(coord, false);
+    mask_.reserve(coord.size());
+
+    for (size_t i = 0; i < coord.size(); ++i) {
+        Latitude lat  = coord.latitudes[i];
+        Longitude lon = Longitude(coord.longitudes[i]).normalise(Longitude::GREENWICH);
 
         if (lat < Latitude::SOUTH_POLE) {
             auto msg = "GRID  returns a latitude of " + std::to_string(lat.value()) +
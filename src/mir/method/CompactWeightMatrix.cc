@@ -0,0 +1,186 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/method/CompactWeightMatrix.h"
+
+#include <limits>
+#include <ostream>
+
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
+#include "mir/util/Types.h"
+
+
+namespace mir::method {
+
+
+namespace {
+
+
+template <typename T>
+void multiply_kernel(const std::vector<CompactWeightMatrix::Index>& outer,
+                     const std::vector<CompactWeightMatrix::Index>& inner, const std::vector<T>& weights, size_t begin,
+                     size_t end, const CompactWeightMatrix::Matrix& x, CompactWeightMatrix::Matrix& y) {
+    const auto nx = x.rows();
+    const auto ny = y.rows();
+
+    for (CompactWeightMatrix::Matrix::Size j = 0; j < x.cols(); ++j) {
+        const auto* xj = x.data() + j * nx;
+        auto* yj       = y.data() + j * ny;
+
+        for (size_t r = begin; r < end; ++r) {
+            double sum = 0.;
+            for (auto k = outer[r]; k < outer[r + 1]; ++k) {
+                sum += double(weights[k]) * xj[inner[k]];
+            }
+            yj[r] = sum;
+        }
+    }
+}
+
+
+void gather_kernel(const std::vector<CompactWeightMatrix::Index>& inner, size_t begin, size_t end,
+                   const CompactWeightMatrix::Matrix& x, CompactWeightMatrix::Matrix& y) {
+    const auto nx = x.rows();
+    const auto ny = y.rows();
+    const auto* k = inner.data();
+
+    for (CompactWeightMatrix::Matrix::Size j = 0; j < x.cols(); ++j) {
+        const auto* xj = x.data() + j * nx;
+        auto* yj       = y.data() + j * ny;
+
+        // no branches (empty rows index column 0, zeroed after)
+        for (size_t r = begin; r < end; ++r) {
+            yj[r] = xj[k[r]];
+        }
+    }
+}
+
+
+}  // namespace
+
+
+CompactWeightMatrix::CompactWeightMatrix(const WeightMatrix& W, bool singlePrecision) :
+    rows_(W.rows()), cols_(W.cols()), nonZeros_(W.nonZeros()), singlePrecision_(singlePrecision) {
+    ASSERT(compactable(W));
+
+    const auto rows = W.rows();
+    const auto nnz  = W.nonZeros();
+
+    const auto* outer = W.outer();
+    const auto* inner = W.inner();
+    const auto* data  = W.data();
+
+    if (gatherable(W)) {
+        inner_.resize(rows);
+        for (size_t r = 0; r < rows; ++r) {
+            if (outer[r] == outer[r + 1]) {
+                inner_[r] = 0;
+                empty_.push_back(Index(r));
+            }
+            else {
+                inner_[r] = Index(inner[outer[r]]);
+            }
+        }
+        return;
+    }
+
+    outer_.assign(outer, outer + rows + 1);
+    inner_.assign(inner, inner + nnz);
+
+    if (singlePrecision) {
+        weightsSingle_.assign(data, data + nnz);
+    }
+    else {
+        weights_.assign(data, data + nnz);
+    }
+}
+
+
+bool CompactWeightMatrix::compactable(const WeightMatrix& W) {
+    constexpr auto max = size_t(std::numeric_limits<Index>::max());
+    return W.rows() < max && W.cols() < max && W.nonZeros() < max;
+}
+
+
+bool CompactWeightMatrix::gatherable(const WeightMatrix& W) {
+    const auto* outer = W.outer();
+    const auto* data  = W.data();
+
+    for (size_t r = 0; r < W.rows(); ++r) {
+        const auto n = outer[r + 1] - outer[r];
+        if (n > 1 || (n == 1 && data[outer[r]] != 1.)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+size_t CompactWeightMatrix::footprint() const {
+    return sizeof(*this) + (outer_.size() + inner_.size() + empty_.size()) * sizeof(Index) +
+           weights_.size() * sizeof(double) + weightsSingle_.size() * sizeof(float);
+}
+
+
+std::vector<size_t> CompactWeightMatrix::emptyRows() const {
+    if (gather()) {
+        return {empty_.begin(), empty_.end()};
+    }
+
+    std::vector<size_t> empty;
+    for (size_t r = 0; r < rows(); ++r) {
+        if (outer_[r] == outer_[r + 1]) {
+            empty.push_back(r);
+        }
+    }
+    return empty;
+}
+
+
+void CompactWeightMatrix::multiply(const Matrix& x, Matrix& y, size_t threads) const {
+    ASSERT(x.rows() == cols());
+    ASSERT(y.rows() == rows());
+    ASSERT(x.cols() == y.cols());
+
+    util::parallel_for(util::parallel_ranges(rows(), threads), [&](size_t, size_t begin, size_t end) {
+        if (gather()) {
+            if (cols() > 0) {  // otherwise, all rows are empty
+                gather_kernel(inner_, begin, end, x, y);
+            }
+        }
+        else if (singlePrecision_) {
+            multiply_kernel(outer_, inner_, weightsSingle_, begin, end, x, y);
+        }
+        else {
+            multiply_kernel(outer_, inner_, weights_, begin, end, x, y);
+        }
+    });
+
+    for (auto r : empty_) {
+        for (Matrix::Size j = 0; j < y.cols(); ++j) {
+            y.data()[j * y.rows() + r] = 0.;
+        }
+    }
+}
+
+
+void CompactWeightMatrix::print(std::ostream& out) const {
+    out << "CompactWeightMatrix[rows=" << rows() << ",cols=" << cols() << ",nonZeros=" << nonZeros()
+        << ",weights=" << (gather() ? "gather" : singlePrecision_ ? "float" : "double")
+        << ",footprint=" << Log::Bytes(footprint()) << "]";
+}
+
+
+}  // namespace mir::method
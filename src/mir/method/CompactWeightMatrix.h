@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "mir/method/WeightMatrix.h"
+
+
+namespace mir::method {
+
+
+/**
+ * Read-only, compact copy of a WeightMatrix for linear interpolation (y = W x), using 32-bit row pointers and column
+ * indices and, optionally, single-precision weights (accumulated in double precision).
+ *
+ * Accuracy (single-precision weights): each weight is rounded to nearest, |δw| <= 2^-24 |w|, so each result value has
+ * an absolute error bounded by 2^-24 Σ |w_j x_j|; for interpolation weights (non-negative, summing to 1) this is a
+ * relative error below 6e-8 of max |x_j| in the stencil.
+ *
+ * Matrices of at most one unit weight per row (such as nearest neighbour) are stored as a gather, of one column index
+ * per row (exact, irrespective of precision) and the list of empty rows, so the multiplication is a branch-free
+ * (vectorisable) indexed load followed by zeroing the empty rows.
+ */
+class CompactWeightMatrix {
+public:
+    // -- Types
+
+    using Index  = std::uint32_t;
+    using Matrix = WeightMatrix::Matrix;
+
+    // -- Constructors
+
+    CompactWeightMatrix(const WeightMatrix&, bool singlePrecision);
+
+    CompactWeightMatrix(const CompactWeightMatrix&)            = delete;
+    CompactWeightMatrix& operator=(const CompactWeightMatrix&) = delete;
+
+    // -- Methods
+
+    /// If matrix indices fit in 32 bits
+    static bool compactable(const WeightMatrix&);
+
+    /// If matrix rows have at most one weight, of value 1
+    static bool gatherable(const WeightMatrix&);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t nonZeros() const { return nonZeros_; }
+    size_t footprint() const;
+    bool singlePrecision() const { return singlePrecision_; }
+    bool gather() const { return outer_.empty(); }
+
+    std::vector<size_t> emptyRows() const;
+
+    /// y = W x (column-major operands, any number of columns), rows partitioned over threads
+    void multiply(const Matrix& x, Matrix& y, size_t threads = 1) const;
+
+private:
+    // -- Members
+
+    size_t rows_;
+    size_t cols_;
+    size_t nonZeros_;
+    std::vector<Index> outer_;  ///< row pointers (empty for a gather)
+    std::vector<Index> inner_;  ///< column indices (for a gather, per row, 0 if empty)
+    std::vector<Index> empty_;  ///< empty rows (for a gather)
+    std::vector<double> weights_;
+    std::vector<float> weightsSingle_;
+    bool singlePrecision_;
+
+    // -- Methods
+
+    void print(std::ostream&) const;
+
+    // -- Friends
+
+    friend std::ostream& operator<<(std::ostream& out, const CompactWeightMatrix& m) {
+        m.print(out);
+        return out;
+    }
+};
+
+
+}  // namespace mir::method
@@ -45,6 +45,18 @@ Method::Method(const param::MIRParametrisation& params) : parametrisation_(param
 Method::~Method() = default;
 
 
+bool Method::canCompose(const Method& /*unused*/) const {
+    return false;
+}
+
+
+bool Method::compose(context::Context& /*unused*/, const repres::Representation& /*unused*/,
+                     const repres::Representation& /*unused*/, const Method& /*unused*/,
+                     const repres::Representation& /*unused*/) const {
+    return false;
+}
+
+
 static util::once_flag once;
 static util::recursive_mutex* local_mutex       = nullptr;
 static std::map<std::string, MethodFactory*>* m = nullptr;
@@ -57,6 +57,14 @@ public:
 
     virtual bool sameAs(const Method&) const = 0;
 
+    /// If interpolation followed by another method can be composed into a single operator
+    virtual bool canCompose(const Method& next) const;
+
+    /// Interpolate through an intermediate representation and another method as a single (composed) operator, returns
+    /// false if not possible for this field (then interpolate in two steps)
+    virtual bool compose(context::Context&, const repres::Representation& in, const repres::Representation& mid,
+                         const Method& next, const repres::Representation& out) const;
+
     // For optimising plan
     virtual bool canCrop() const                         = 0;
     virtual void setCropping(const util::BoundingBox&)   = 0;
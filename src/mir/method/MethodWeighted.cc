@@ -13,10 +13,17 @@
 #include "mir/method/MethodWeighted.h"
 
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
 #include <limits>
+#include <map>
+#include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 
+#include "eckit/config/Resource.h"
 #include "eckit/types/FloatCompare.h"
 #include "eckit/utils/MD5.h"
 #include "eckit/utils/StringTools.h"
@@ -28,6 +35,7 @@
 #include "mir/data/MIRFieldStats.h"
 #include "mir/data/Space.h"
 #include "mir/lsm/LandSeaMasks.h"
+#include "mir/method/CompactWeightMatrix.h"
 #include "mir/method/MatrixCacheCreator.h"
 #include "mir/method/nonlinear/NonLinear.h"
 #include "mir/method/solver/Multiply.h"
@@ -36,6 +44,7 @@
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
 #include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
 
@@ -44,10 +53,134 @@ namespace mir::method {
 
 
 static util::recursive_mutex local_mutex;
+static std::map<std::string, std::shared_future<std::shared_ptr<const WeightMatrix>>> matrix_in_flight;
 
 constexpr size_t CAPACITY = 512 * 1024 * 1024;
 static caching::InMemoryCache<WeightMatrix> matrix_cache("mirMatrix", CAPACITY, 0,
                                                          "$MIR_MATRIX_CACHE_MEMORY_FOOTPRINT");
+static caching::InMemoryCache<CompactWeightMatrix> compact_cache("mirMatrixCompact", CAPACITY, 0,
+                                                                 "$MIR_MATRIX_COMPACT_CACHE_MEMORY_FOOTPRINT");
+
+
+static caching::InMemoryCacheUsage cache_usage(const WeightMatrix& W) {
+    const auto footprint = W.footprint();
+    return W.inSharedMemory() ? caching::InMemoryCacheUsage(size_t(0), footprint)
+                              : caching::InMemoryCacheUsage(footprint, size_t(0));
+}
+
+
+static caching::InMemoryCacheUsage cache_usage(const CompactWeightMatrix& C) {
+    return caching::InMemoryCacheUsage(C.footprint(), size_t(0));
+}
+
+
+// insert (complete) matrix in the in-memory cache, unless created concurrently meanwhile; the returned handle keeps
+// the matrix (it is not purged while in use)
+template <typename T>
+static std::shared_ptr<const T> cache_insert(caching::InMemoryCache<T>& cache, const std::string& key,
+                                             std::unique_ptr<T> M) {
+    ASSERT(M);
+
+    static util::recursive_mutex mutex;
+    util::lock_guard<util::recursive_mutex> lock(mutex);
+
+    if (auto j = cache.find(key); j) {
+        return j;
+    }
+
+    const auto usage = cache_usage(*M);
+    return cache.insert(key, M.release(), usage);
+}
+
+
+// keys of matrices known not to have a form (checked once), forgetting the oldest beyond capacity
+class KnownKeys {
+public:
+    explicit KnownKeys(size_t capacity) : capacity_(capacity) { ASSERT(capacity_ > 0); }
+
+    bool contains(const std::string& key) const {
+        util::lock_guard<util::recursive_mutex> lock(mutex_);
+        return keys_.find(key) != keys_.end();
+    }
+
+    void insert(const std::string& key) {
+        util::lock_guard<util::recursive_mutex> lock(mutex_);
+        if (keys_.insert(key).second) {
+            order_.push_back(key);
+            if (order_.size() > capacity_) {
+                keys_.erase(order_.front());
+                order_.pop_front();
+            }
+        }
+    }
+
+private:
+    mutable util::recursive_mutex mutex_;
+    std::set<std::string> keys_;
+    std::deque<std::string> order_;
+    const size_t capacity_;
+};
+
+
+constexpr size_t KNOWN_KEYS_CAPACITY = 1024;
+static KnownKeys not_compact(KNOWN_KEYS_CAPACITY);
+static KnownKeys not_composed(KNOWN_KEYS_CAPACITY);
+
+
+// C = A B (sparse), rows in parallel
+static void sparse_product(const WeightMatrix& A, const WeightMatrix& B, WeightMatrix& C, size_t threads) {
+    ASSERT(A.cols() == B.rows());
+    ASSERT(C.rows() == A.rows() && C.cols() == B.cols());
+
+    const auto ranges = util::parallel_ranges(A.rows(), threads);
+    std::vector<std::vector<WeightMatrix::Triplet>> triplets(ranges.size());
+
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        auto& local = triplets[r];
+
+        // row accumulator (sparse, by column)
+        std::vector<double> sum(B.cols(), 0.);
+        std::vector<size_t> row(B.cols(), A.rows());
+        std::vector<size_t> cols;
+
+        for (size_t i = begin; i < end; ++i) {
+            cols.clear();
+            for (auto k = A.outer()[i]; k < A.outer()[i + 1]; ++k) {
+                const auto a = A.data()[k];
+                const auto m = size_t(A.inner()[k]);
+                for (auto l = B.outer()[m]; l < B.outer()[m + 1]; ++l) {
+                    const auto j = size_t(B.inner()[l]);
+                    if (row[j] != i) {
+                        row[j] = i;
+                        sum[j] = 0.;
+                        cols.push_back(j);
+                    }
+                    sum[j] += a * B.data()[l];
+                }
+            }
+
+            std::sort(cols.begin(), cols.end());
+            for (auto j : cols) {
+                local.emplace_back(i, j, sum[j]);
+            }
+        }
+    });
+
+    // merge in range order
+    size_t size = 0;
+    for (const auto& local : triplets) {
+        size += local.size();
+    }
+
+    std::vector<WeightMatrix::Triplet> merged;
+    merged.reserve(size);
+    for (auto& local : triplets) {
+        merged.insert(merged.end(), local.begin(), local.end());
+        std::vector<WeightMatrix::Triplet>().swap(local);
+    }
+
+    C.setFromTriplets(merged);
+}
 
 
 MethodWeighted::MethodWeighted(const param::MIRParametrisation& parametrisation) :
@@ -59,6 +192,15 @@ MethodWeighted::MethodWeighted(const param::MIRParametrisation& parametrisation)
 
     matrixValidate_ = eckit::Resource<bool>("$MIR_MATRIX_VALIDATE", false);
     matrixAssemble_ = parametrisation_.userParametrisation().has("filter");
+    matrixGather_   = eckit::Resource<bool>("$MIR_MATRIX_GATHER", true);
+    parametrisation_.get("matrix-gather", matrixGather_);
+
+    matrixCompact_ = eckit::Resource<std::string>("$MIR_MATRIX_COMPACT", "none");
+    parametrisation_.get("matrix-compact", matrixCompact_);
+    if (matrixCompact_ != "none" && matrixCompact_ != "double" && matrixCompact_ != "float") {
+        throw exception::UserError("MethodWeighted: matrix-compact should be one of none, double or float, not '" +
+                                   matrixCompact_ + "'");
+    }
 
     std::string nonLinear = "missing-if-heaviest-missing";
     parametrisation_.get("non-linear", nonLinear);
@@ -123,23 +265,11 @@ void MethodWeighted::createMatrix(context::Context& ctx, const repres::Represent
     }
 }
 
-// This returns a 'const' matrix so we ensure that we don't change it and break the in-memory cache
-const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repres::Representation& in,
-                                              const repres::Representation& out) const {
+void MethodWeighted::cacheKeys(const repres::Representation& in, const repres::Representation& out,
+                               const lsm::LandSeaMasks& masks, std::string& disk_key, std::string& memory_key) const {
+    // lock only for computing keys (representations set their unique names lazily)
     util::lock_guard<util::recursive_mutex> lock(local_mutex);
 
-    auto& log = Log::debug();
-
-    log << "MethodWeighted::getMatrix " << *this << std::endl;
-    trace::Timer timer("MethodWeighted::getMatrix");
-
-    double here                   = timer.elapsed();
-    const lsm::LandSeaMasks masks = getMasks(in, out);
-    log << "MethodWeighted::getMatrix land-sea masks: " << timer.elapsedSeconds(here) << ", "
-        << (masks.active() ? "active" : "not active") << std::endl;
-
-
-    here                             = timer.elapsed();
     const std::string& shortName_in  = in.uniqueName();
     const std::string& shortName_out = out.uniqueName();
 
@@ -155,9 +285,9 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
         version_str = std::to_string(v) + "/";
     }
 
-    std::string disk_key =
+    disk_key =
         std::string(name()) + "/" + version_str + shortName_in + "/" + shortName_out + "-" + std::string(hash);
-    std::string memory_key = disk_key;
+    memory_key = disk_key;
 
     // Add masks if any
     if (masks.active()) {
@@ -167,24 +297,92 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
             disk_key += masks_key;
         }
     }
+}
+
+
+// This returns a 'const' matrix so we ensure that we don't change it and break the in-memory cache
+std::shared_ptr<const WeightMatrix> MethodWeighted::getMatrix(context::Context& ctx, const repres::Representation& in,
+                                                              const repres::Representation& out) const {
+    auto& log = Log::debug();
+
+    log << "MethodWeighted::getMatrix " << *this << std::endl;
+    trace::Timer timer("MethodWeighted::getMatrix");
+
+    double here                   = timer.elapsed();
+    const lsm::LandSeaMasks masks = getMasks(in, out);
+    log << "MethodWeighted::getMatrix land-sea masks: " << timer.elapsedSeconds(here) << ", "
+        << (masks.active() ? "active" : "not active") << std::endl;
+
+
+    std::string disk_key;
+    std::string memory_key;
+    cacheKeys(in, out, masks, disk_key, memory_key);
+
+
+    here = timer.elapsed();
+
+    auto j     = matrix_cache.find(memory_key);
+    auto found = bool(j);
+    log << "MethodWeighted::getMatrix cache key: " << memory_key << " " << timer.elapsedSeconds(here) << ", "
+        << (found ? "found" : "not found") << " in memory cache" << std::endl;
+    if (found) {
+        log << "Using matrix from InMemoryCache " << *j << std::endl;
+        return j;
+    }
 
+    // concurrent requests for the same key wait on a single creation (sharing its matrix), other keys proceed
+    // independently
+    std::promise<std::shared_ptr<const WeightMatrix>> promise;
+    std::shared_future<std::shared_ptr<const WeightMatrix>> future;
 
     {
-        auto j     = matrix_cache.find(memory_key);
-        auto found = j != matrix_cache.end();
-        log << "MethodWeighted::getMatrix cache key: " << memory_key << " " << timer.elapsedSeconds(here) << ", "
-            << (found ? "found" : "not found") << " in memory cache" << std::endl;
-        if (found) {
-            const WeightMatrix& mat = *j;
-            log << "Using matrix from InMemoryCache " << mat << std::endl;
-            return mat;
+        util::lock_guard<util::recursive_mutex> lock(local_mutex);
+
+        if (auto k = matrix_in_flight.find(memory_key); k != matrix_in_flight.end()) {
+            future = k->second;
+        }
+        else if (j = matrix_cache.find(memory_key); j) {
+            // created since the lookup above
+            return j;
+        }
+        else {
+            matrix_in_flight.emplace(memory_key, promise.get_future().share());
         }
     }
 
+    if (future.valid()) {
+        log << "MethodWeighted::getMatrix waiting for matrix creation: " << memory_key << std::endl;
+        return future.get();  // rethrows if creation failed
+    }
+
+    try {
+        auto W = cacheMatrix(ctx, in, out, masks, disk_key, memory_key);
+        ASSERT(W);
+
+        util::lock_guard<util::recursive_mutex> lock(local_mutex);
+        matrix_in_flight.erase(memory_key);
+        promise.set_value(W);
+        return W;
+    }
+    catch (...) {
+        util::lock_guard<util::recursive_mutex> lock(local_mutex);
+        matrix_in_flight.erase(memory_key);
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+
+std::shared_ptr<const WeightMatrix> MethodWeighted::cacheMatrix(context::Context& ctx, const repres::Representation& in,
+                                                                const repres::Representation& out,
+                                                                const lsm::LandSeaMasks& masks,
+                                                                const std::string& disk_key,
+                                                                const std::string& memory_key) const {
+    auto& log = Log::debug();
+    trace::Timer timer("MethodWeighted::cacheMatrix");
 
     // calculate weights matrix, apply mask if necessary
-    here = timer.elapsed();
-    WeightMatrix W(out.numberOfPoints(), in.numberOfPoints());
+    std::unique_ptr<WeightMatrix> W(new WeightMatrix(out.numberOfPoints(), in.numberOfPoints()));
 
     bool caching = LibMir::caching();
     parametrisation_.get("caching", caching);
@@ -195,36 +393,70 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
         // as caching may be disabled on a field by field basis (unstructured grids)
         static caching::WeightCache cache(parametrisation_);
         MatrixCacheCreator creator(*this, ctx, in, out, masks, cropping_);
-        cache.getOrCreate(disk_key, creator, W);
+        cache.getOrCreate(disk_key, creator, *W);
     }
     else {
-        createMatrix(ctx, in, out, W, masks, cropping_);
+        createMatrix(ctx, in, out, *W, masks, cropping_);
     }
 
     // If LSM not cacheable to disk, because it is user provided
     // it will be cached in memory nevertheless
     if (masks.active() && !masks.cacheable()) {
-        applyMasks(W, masks);
+        applyMasks(*W, masks);
         if (matrixValidate_) {
-            W.validate("applyMasks");
+            W->validate("applyMasks");
         }
     }
 
-    log << "MethodWeighted::getMatrix create weights matrix: " << timer.elapsedSeconds(here) << std::endl;
-    log << "MethodWeighted::getMatrix matrix W " << W << std::endl;
+    log << "MethodWeighted::getMatrix create weights matrix: " << timer.elapsedSeconds() << std::endl;
+    log << "MethodWeighted::getMatrix matrix W " << *W << std::endl;
+
+    log << "Matrix footprint " << W->owner() << " " << cache_usage(*W) << std::endl;
+
+    return cache_insert(matrix_cache, memory_key, std::move(W));
+}
+
+
+std::shared_ptr<const CompactWeightMatrix> MethodWeighted::getCompactMatrix(context::Context& ctx,
+                                                                            const repres::Representation& in,
+                                                                            const repres::Representation& out,
+                                                                            const std::string& compact) const {
+    ASSERT(compact == "gather" || compact == "double" || compact == "float");
+
+    auto& log = Log::debug();
+    trace::Timer timer("MethodWeighted::getCompactMatrix");
+
+    const lsm::LandSeaMasks masks = getMasks(in, out);
+
+    std::string disk_key;
+    std::string memory_key;
+    cacheKeys(in, out, masks, disk_key, memory_key);
+    memory_key += "-compact-" + compact;
 
-    // insert matrix in the in-memory cache and update memory footprint
+    if (auto j = compact_cache.find(memory_key); j) {
+        log << "Using compact matrix from InMemoryCache " << *j << std::endl;
+        return j;
+    }
+
+    if (not_compact.contains(memory_key)) {
+        return nullptr;
+    }
 
-    WeightMatrix& w = matrix_cache[memory_key];
-    W.swap(w);
+    // derive from the (cached) full matrix, which can then age out of the in-memory cache
+    const auto W = getMatrix(ctx, in, out);
+    if (!CompactWeightMatrix::compactable(*W) || (compact == "gather" && !CompactWeightMatrix::gatherable(*W))) {
+        log << "MethodWeighted::getCompactMatrix matrix not compactable (" << compact << "), using " << *W
+            << std::endl;
 
-    size_t footprint = w.footprint();
-    caching::InMemoryCacheUsage usage(w.inSharedMemory() ? 0 : footprint, w.inSharedMemory() ? footprint : 0);
+        not_compact.insert(memory_key);
+        return nullptr;
+    }
 
-    log << "Matrix footprint " << w.owner() << " " << usage << " W -> " << W.owner() << std::endl;
+    std::unique_ptr<CompactWeightMatrix> C(new CompactWeightMatrix(*W, compact == "float"));
+    log << "MethodWeighted::getCompactMatrix create compact matrix: " << timer.elapsedSeconds() << ", " << *C
+        << std::endl;
 
-    matrix_cache.footprint(memory_key, usage);
-    return w;
+    return cache_insert(compact_cache, memory_key, std::move(C));
 }
 
 
@@ -285,6 +517,73 @@ void MethodWeighted::setVectorFromOperandMatrix(const WeightMatrix::Matrix& A, M
 }
 
 
+void MethodWeighted::solveBatch(context::Context& ctx, const WeightMatrix* W, const CompactWeightMatrix* compact,
+                                const data::MIRField& field, size_t begin, size_t end, const double& missingValue,
+                                const data::Space& space, std::vector<MIRValuesVector>& results) const {
+    ASSERT(begin < end && end <= field.dimensions());
+    ASSERT(W != nullptr || compact != nullptr);
+
+    const auto n        = end - begin;
+    const auto npts_inp = compact != nullptr ? compact->cols() : W->cols();
+    const auto npts_out = compact != nullptr ? compact->rows() : W->rows();
+
+    std::ostringstream os;
+    os << "Interpolating " << Log::Pretty(n, {"field"}) << " (" << Log::Pretty(npts_inp) << " -> "
+       << Log::Pretty(npts_out) << ")";
+    trace::Timer timer(os.str());
+
+    // set input matrix B (from A = W × B), column-blocked: the (linearised) columns of each dimension are contiguous
+    WeightMatrix::Matrix B;
+    size_t cols = 0;
+    for (size_t i = begin; i < end; ++i) {
+        const auto& values = field.values(i);
+        ASSERT(values.size() == npts_inp);
+
+        // FIXME: remove const_cast once Matrix provides read-only view
+        WeightMatrix::Matrix Bwrap(const_cast<double*>(values.data()), npts_inp, 1);
+        WeightMatrix::Matrix Bi;
+        space.linearise(Bwrap, Bi, missingValue);
+
+        if (i == begin) {
+            cols = Bi.cols();
+            WeightMatrix::Matrix tmp(npts_inp, n * cols);
+            B.swap(tmp);
+        }
+
+        ASSERT(Bi.rows() == npts_inp && Bi.cols() == cols);
+        std::copy(Bi.data(), Bi.data() + npts_inp * cols, B.data() + (i - begin) * npts_inp * cols);
+    }
+
+    WeightMatrix::Matrix A(npts_out, n * cols);
+    {
+        auto timing(ctx.statistics().matrixTimer());
+        if (compact != nullptr) {
+            compact->multiply(B, A, util::parallel_threads(parametrisation_));
+        }
+        else {
+            solver_->solve(B, *W, A, missingValue);
+        }
+    }
+
+    // set output vectors from each block of A
+    results.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        WeightMatrix::Matrix Ai(A.data() + i * npts_out * cols, npts_out, cols);
+
+        auto& result = results[i];
+        result.resize(npts_out);
+
+        WeightMatrix::Matrix Awrap(result.data(), npts_out, 1);
+        space.unlinearise(Ai, Awrap, missingValue);
+
+        // unlinearise might only shallow-copy its input
+        if (Awrap.data() != result.data()) {
+            std::copy(Awrap.data(), Awrap.data() + npts_out, result.begin());
+        }
+    }
+}
+
+
 lsm::LandSeaMasks MethodWeighted::getMasks(const repres::Representation& in, const repres::Representation& out) const {
     return lsm::LandSeaMasks::lookup(parametrisation_, in, out);
 }
@@ -297,10 +596,128 @@ bool MethodWeighted::validateMatrixWeights() const {
 
 void MethodWeighted::execute(context::Context& ctx, const repres::Representation& in,
                              const repres::Representation& out) const {
+    interpolate(ctx, in, out, nullptr);
+}
+
+
+bool MethodWeighted::canCompose(const Method& next) const {
+    const auto* o = dynamic_cast<const MethodWeighted*>(&next);
+    return o != nullptr && dynamic_cast<const solver::Multiply*>(solver_.get()) != nullptr &&
+           dynamic_cast<const solver::Multiply*>(o->solver_.get()) != nullptr;
+}
+
+
+bool MethodWeighted::compose(context::Context& ctx, const repres::Representation& in,
+                             const repres::Representation& mid, const Method& next,
+                             const repres::Representation& out) const {
+    ASSERT(canCompose(next));
+    const auto& o = dynamic_cast<const MethodWeighted&>(next);
+
+    if (!linear(ctx.field()) || !o.linear(ctx.field())) {
+        return false;
+    }
+
+    auto W = getComposedMatrix(ctx, in, mid, o, out);
+    if (!W) {
+        return false;
+    }
+
+    interpolate(ctx, in, out, W);
+    return true;
+}
+
+
+bool MethodWeighted::linear(const data::MIRField& field) const {
+    std::string space;
+    parametrisation_.get("vector-space", space);
+
+    return space == "1d-linear" && dynamic_cast<const solver::Multiply*>(solver_.get()) != nullptr &&
+           std::none_of(nonLinear_.begin(), nonLinear_.end(),
+                        [&field](const std::unique_ptr<const nonlinear::NonLinear>& n) {
+                            return n->modifiesMatrix(field.hasMissing());
+                        });
+}
+
+
+std::shared_ptr<const WeightMatrix> MethodWeighted::getComposedMatrix(context::Context& ctx,
+                                                                      const repres::Representation& in,
+                                                                      const repres::Representation& mid,
+                                                                      const MethodWeighted& next,
+                                                                      const repres::Representation& out) const {
+    auto& log = Log::debug();
+    trace::Timer timer("MethodWeighted::getComposedMatrix");
+
+    std::string disk_key1;
+    std::string disk_key2;
+    std::string memory_key1;
+    std::string memory_key2;
+    cacheKeys(in, mid, getMasks(in, mid), disk_key1, memory_key1);
+    next.cacheKeys(mid, out, next.getMasks(mid, out), disk_key2, memory_key2);
+
+    const auto memory_key = "composed/" + memory_key1 + "/" + memory_key2;
+
+    if (auto j = matrix_cache.find(memory_key); j) {
+        log << "Using composed matrix from InMemoryCache " << *j << std::endl;
+        return j;
+    }
+
+    if (not_composed.contains(memory_key)) {
+        return nullptr;
+    }
+
+    // intermediate points without weights would be missing values (composition would ignore them)
+    const auto W1 = getMatrix(ctx, in, mid);
+    for (size_t r = 0; r < W1->rows(); ++r) {
+        if (W1->outer()[r] == W1->outer()[r + 1]) {
+            log << "MethodWeighted::getComposedMatrix intermediate has missing values, not composable" << std::endl;
+
+            not_composed.insert(memory_key);
+            return nullptr;
+        }
+    }
+
+    auto create = [&](WeightMatrix& W) {
+        const auto W2 = next.getMatrix(ctx, mid, out);
+        sparse_product(*W2, *W1, W, util::parallel_threads(parametrisation_));
+        W.cleanup(pruneEpsilon_);
+    };
+
+    std::unique_ptr<WeightMatrix> W(new WeightMatrix(out.numberOfPoints(), in.numberOfPoints()));
+
+    bool caching = LibMir::caching();
+    parametrisation_.get("caching", caching);
+
+    // on disk, if both matrices are (not the case with user-provided land-sea masks)
+    if (caching && disk_key1 == memory_key1 && disk_key2 == memory_key2) {
+        class ComposedCacheCreator final : public caching::WeightCache::CacheContentCreator {
+            const std::function<void(WeightMatrix&)>& create_;
+            void create(const eckit::PathName& /*path*/, WeightMatrix& W, bool& /*saved*/) override { create_(W); }
 
+        public:
+            explicit ComposedCacheCreator(const std::function<void(WeightMatrix&)>& create) : create_(create) {}
+        };
 
-    // Make sure another thread to no evict anything from the cache while we are using it
-    auto cacheUse(ctx.statistics().cacheUser(matrix_cache));
+        eckit::MD5 hash;
+        hash << disk_key1 << disk_key2;
+
+        static caching::WeightCache cache(parametrisation_);
+        const std::function<void(WeightMatrix&)> f(create);
+        ComposedCacheCreator creator(f);
+        cache.getOrCreate("composed/" + std::string(hash), creator, *W);
+    }
+    else {
+        create(*W);
+    }
+
+    log << "MethodWeighted::getComposedMatrix composed matrix: " << timer.elapsedSeconds() << ", " << *W << std::endl;
+
+    return cache_insert(matrix_cache, memory_key, std::move(W));
+}
+
+
+void MethodWeighted::interpolate(context::Context& ctx, const repres::Representation& in,
+                                 const repres::Representation& out,
+                                 const std::shared_ptr<const WeightMatrix>& composed) const {
 
     static bool check_stats = eckit::Resource<bool>("mirCheckStats", false);
 
@@ -312,22 +729,6 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
     const size_t npts_inp = in.numberOfPoints();
     const size_t npts_out = out.numberOfPoints();
 
-    const WeightMatrix& W = getMatrix(ctx, in, out);
-    ASSERT(W.rows() == npts_out);
-    ASSERT(W.cols() == npts_inp);
-
-    std::vector<size_t> forceMissing;  // reserving size unnecessary (not the general case)
-    {
-        auto begin = W.begin(0);
-        auto end(begin);
-        for (size_t r = 0; r < W.rows(); r++) {
-            if (begin == (end = W.end(r))) {
-                forceMissing.push_back(r);
-            }
-            begin = end;
-        }
-    }
-
     // ensure unique missingValue on no input missing values
     data::MIRField& field = ctx.field();
     const bool hasMissing = field.hasMissing();
@@ -343,9 +744,70 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
                                             return n->modifiesMatrix(field.hasMissing());
                                         });
 
+    // ... unless non-linear treatments can be applied on the fly, row by row (default solver only)
+    const auto* multiply = dynamic_cast<const solver::Multiply*>(solver_.get());
+    const bool rowWise   = matrixCopy && multiply != nullptr && !matrixValidate_ &&
+                         std::all_of(nonLinear_.begin(), nonLinear_.end(),
+                                     [](const std::unique_ptr<const nonlinear::NonLinear>& n) { return n->rowWise(); });
+
+    // gather matrix: rows of at most one unit weight (such as nearest neighbour), with non-linear treatments leaving
+    // these unchanged (default solver only)
+    const bool gather = matrixGather_ && multiply != nullptr && !matrixValidate_ &&
+                        std::all_of(nonLinear_.begin(), nonLinear_.end(),
+                                    [&field](const std::unique_ptr<const nonlinear::NonLinear>& n) {
+                                        return n->gatherInvariant() || !n->modifiesMatrix(field.hasMissing());
+                                    });
+
+    // compact matrix: linear interpolation with the default solver only (otherwise, or if not compactable, full matrix)
+    auto compact = gather && !composed ? getCompactMatrix(ctx, in, out, "gather") : nullptr;
+    if (!compact && !composed && matrixCompact_ != "none" && !matrixCopy && multiply != nullptr) {
+        compact = getCompactMatrix(ctx, in, out, matrixCompact_);
+    }
+
+    const auto matrix     = compact ? nullptr : composed ? composed : getMatrix(ctx, in, out);
+    const WeightMatrix* W = matrix.get();
+
+    std::vector<size_t> forceMissing;  // reserving size unnecessary (not the general case)
+    if (compact) {
+        ASSERT(compact->rows() == npts_out);
+        ASSERT(compact->cols() == npts_inp);
+        forceMissing = compact->emptyRows();
+    }
+    else {
+        ASSERT(W->rows() == npts_out);
+        ASSERT(W->cols() == npts_inp);
+
+        auto begin = W->begin(0);
+        auto end(begin);
+        for (size_t r = 0; r < W->rows(); r++) {
+            if (begin == (end = W->end(r))) {
+                forceMissing.push_back(r);
+            }
+            begin = end;
+        }
+    }
+
+
+    std::string space;
+    parametrisation_.get("vector-space", space);
+    const data::Space& sp = data::SpaceChooser::lookup(space);
+
+    // linear interpolation of more than one dimension: multiply blocks of dimensions at once (sparse matrix-matrix
+    // product), amortising the matrix traversal
+    static const size_t matrixBatch = eckit::Resource<size_t>("$MIR_MATRIX_BATCH", 32);
+    const bool batch = (!matrixCopy || compact) && multiply != nullptr && matrixBatch > 1 && field.dimensions() > 1;
+
+    std::vector<MIRValuesVector> batchResults;
+    size_t batchBegin = 0;
 
     for (size_t i = 0; i < field.dimensions(); i++) {
 
+        if (batch && i == batchBegin + batchResults.size()) {
+            batchBegin = i;
+            solveBatch(ctx, W, compact.get(), field, i, std::min(i + matrixBatch, field.dimensions()), missingValue,
+                       sp, batchResults);
+        }
+
         std::ostringstream os;
         os << "Interpolating field (" << Log::Pretty(npts_inp) << " -> " << Log::Pretty(npts_out) << ")";
         trace::Timer trace(os.str());
@@ -357,45 +819,56 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
             istats = field.statistics(i);
         }
 
-        // Get input/output matrices
-        std::string space;
-        parametrisation_.get("vector-space", space);
-        const data::Space& sp = data::SpaceChooser::lookup(space);
-
         MIRValuesVector result(npts_out);  // field.update() takes ownership with std::swap()
-        WeightMatrix::Matrix A;
-        WeightMatrix::Matrix B;
-        setOperandMatricesFromVectors(B, A, result, field.values(i), missingValue, sp);
-        ASSERT(A.rows() == npts_inp);
-        ASSERT(B.rows() == npts_out);
 
+        if (batch) {
+            result.swap(batchResults.at(i - batchBegin));
+        }
+        else {
+            // Get input/output matrices
+            WeightMatrix::Matrix A;
+            WeightMatrix::Matrix B;
+            setOperandMatricesFromVectors(B, A, result, field.values(i), missingValue, sp);
+            ASSERT(A.rows() == npts_inp);
+            ASSERT(B.rows() == npts_out);
 
-        if (matrixCopy) {
-            auto timing(ctx.statistics().matrixTimer());
-            WeightMatrix M(W);  // modifiable matrix copy
-
-            for (const auto& n : nonLinear_) {
-                std::ostringstream str;
-                str << *n;
-                trace::Timer t(str.str());
 
-                if (n->treatment(A, M, B, field.values(i), missingValue)) {
-                    if (matrixValidate_) {
-                        M.validate(str.str().c_str());
+            if (compact) {
+                auto timing(ctx.statistics().matrixTimer());
+                compact->multiply(A, B, util::parallel_threads(parametrisation_));
+            }
+            else if (rowWise) {
+                auto timing(ctx.statistics().matrixTimer());
+                multiply->solve(A, *W, B, missingValue, field.values(i), nonLinear_,
+                                util::parallel_threads(parametrisation_));
+            }
+            else if (matrixCopy) {
+                auto timing(ctx.statistics().matrixTimer());
+                WeightMatrix M(*W);  // modifiable matrix copy
+
+                for (const auto& n : nonLinear_) {
+                    std::ostringstream str;
+                    str << *n;
+                    trace::Timer t(str.str());
+
+                    if (n->treatment(A, M, B, field.values(i), missingValue)) {
+                        if (matrixValidate_) {
+                            M.validate(str.str().c_str());
+                        }
                     }
                 }
-            }
 
-            solver_->solve(A, M, B, missingValue);
-        }
-        else {
-            auto timing(ctx.statistics().matrixTimer());
-            solver_->solve(A, W, B, missingValue);
-        }
+                solver_->solve(A, M, B, missingValue);
+            }
+            else {
+                auto timing(ctx.statistics().matrixTimer());
+                solver_->solve(A, *W, B, missingValue);
+            }
 
 
-        // update field values with interpolation result
-        setVectorFromOperandMatrix(B, result, missingValue, sp);
+            // update field values with interpolation result
+            setVectorFromOperandMatrix(B, result, missingValue, sp);
+        }
 
         for (auto& r : forceMissing) {
             result[r] = missingValue;
@@ -410,6 +883,9 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
                 << "Output field statistics: " << ostats << std::endl;
         }
     }
+
+    ctx.statistics().cacheStatistics(matrix_cache);
+    ctx.statistics().cacheStatistics(compact_cache);
 }
 
 
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "mir/method/Cropping.h"
@@ -22,12 +23,14 @@
 
 namespace mir {
 namespace data {
+class MIRField;
 class Space;
 }
 namespace lsm {
 class LandSeaMasks;
 }
 namespace method {
+class CompactWeightMatrix;
 namespace nonlinear {
 class NonLinear;
 }
@@ -77,8 +80,9 @@ public:
 
     int version() const override;
 
-    virtual const WeightMatrix& getMatrix(context::Context&, const repres::Representation& in,
-                                          const repres::Representation& out) const;
+    /// Matrix from the in-memory cache (the handle prevents its eviction while in use)
+    virtual std::shared_ptr<const WeightMatrix> getMatrix(context::Context&, const repres::Representation& in,
+                                                          const repres::Representation& out) const;
 
     // -- Overridden methods
     // None
@@ -124,6 +128,8 @@ private:
 
     bool matrixValidate_;
     bool matrixAssemble_;
+    bool matrixGather_;
+    std::string matrixCompact_;
 
     // -- Methods
 
@@ -137,12 +143,37 @@ private:
                               WeightMatrix&, bool validate) const;
     void createMatrix(context::Context&, const repres::Representation& in, const repres::Representation& out,
                       WeightMatrix&, const lsm::LandSeaMasks&, const Cropping&) const;
+    std::shared_ptr<const WeightMatrix> cacheMatrix(context::Context&, const repres::Representation& in,
+                                                    const repres::Representation& out, const lsm::LandSeaMasks&,
+                                                    const std::string& disk_key, const std::string& memory_key) const;
+    std::shared_ptr<const CompactWeightMatrix> getCompactMatrix(context::Context&, const repres::Representation& in,
+                                                                const repres::Representation& out,
+                                                                const std::string& compact) const;
+    void cacheKeys(const repres::Representation& in, const repres::Representation& out, const lsm::LandSeaMasks&,
+                   std::string& disk_key, std::string& memory_key) const;
 
     /// Get interpolation operand matrices, from A = W B
     virtual void setOperandMatricesFromVectors(WeightMatrix::Matrix& A, WeightMatrix::Matrix& B,
                                                const MIRValuesVector& Avector, const MIRValuesVector& Bvector,
                                                const double& missingValue, const data::Space&) const;
 
+    /// Interpolate dimensions [begin, end) of a field at once (column-blocked operands), from A = W B
+    void solveBatch(context::Context&, const WeightMatrix*, const CompactWeightMatrix*, const data::MIRField&,
+                    size_t begin, size_t end, const double& missingValue, const data::Space&,
+                    std::vector<MIRValuesVector>& results) const;
+
+    /// Interpolate with the given (composed) matrix, or the method's own matrix if null
+    void interpolate(context::Context&, const repres::Representation& in, const repres::Representation& out,
+                     const std::shared_ptr<const WeightMatrix>& composed) const;
+
+    /// Matrix of this method (in to mid) followed by another (mid to out), null if not composable
+    std::shared_ptr<const WeightMatrix> getComposedMatrix(context::Context&, const repres::Representation& in,
+                                                          const repres::Representation& mid, const MethodWeighted& next,
+                                                          const repres::Representation& out) const;
+
+    /// If interpolating a field is linear (no non-linear treatments modify the matrix, default solver and space)
+    bool linear(const data::MIRField&) const;
+
     /// Get interpolation operand matrices, from A = W B
     virtual void setVectorFromOperandMatrix(const WeightMatrix::Matrix& A, MIRValuesVector& Avector,
                                             const double& missingValue, const data::Space&) const;
@@ -151,6 +182,9 @@ private:
 
     // From Method
     void execute(context::Context&, const repres::Representation& in, const repres::Representation& out) const override;
+    bool canCompose(const Method&) const override;
+    bool compose(context::Context&, const repres::Representation& in, const repres::Representation& mid,
+                 const Method& next, const repres::Representation& out) const override;
     bool canCrop() const override;
     void setCropping(const util::BoundingBox&) override;
     bool hasCropping() const override;
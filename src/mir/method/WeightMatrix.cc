@@ -13,9 +13,16 @@
 #include "mir/method/WeightMatrix.h"
 
 #include <cmath>
+#include <memory>
 
+#include <unistd.h>
+
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/maths/Functions.h"
 #include "eckit/types/FloatCompare.h"
 
+#include "mir/caching/matrix/FileLoader.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
 #include "mir/util/Types.h"
@@ -27,9 +34,8 @@ namespace mir::method {
 WeightMatrix::WeightMatrix(SparseMatrix::Allocator* alloc) : SparseMatrix(alloc) {}
 
 
-WeightMatrix::WeightMatrix(const eckit::PathName& path) {
-    load(path);
-}
+WeightMatrix::WeightMatrix(const eckit::PathName& path) :
+    SparseMatrix(new caching::matrix::FileLoader("file-io", path)) {}
 
 
 WeightMatrix::WeightMatrix(WeightMatrix::Size rows, WeightMatrix::Size cols) : SparseMatrix(rows, cols) {}
@@ -45,6 +51,21 @@ void WeightMatrix::setFromTriplets(const std::vector<WeightMatrix::Triplet>& tri
 }
 
 
+void WeightMatrix::save(const eckit::PathName& path) const {
+    long page_size = ::sysconf(_SC_PAGESIZE);
+    ASSERT(page_size > 0);
+
+    std::vector<char> buffer(eckit::round(footprint(), size_t(page_size)), 0);
+    dump(buffer.data(), buffer.size());
+
+    std::unique_ptr<eckit::DataHandle> dh(path.fileHandle());
+    dh->openForWrite(eckit::Length(buffer.size()));
+    auto c = eckit::closer(*dh);
+
+    ASSERT(dh->write(buffer.data(), long(buffer.size())) == long(buffer.size()));
+}
+
+
 void WeightMatrix::print(std::ostream& os) const {
     os << "WeightMatrix[";
     SparseMatrix::print(os);
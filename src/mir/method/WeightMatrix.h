@@ -34,6 +34,7 @@ public:  // types
 public:  // methods
     WeightMatrix(SparseMatrix::Allocator* = nullptr);
 
+    /// Load a matrix file (see save)
     WeightMatrix(const eckit::PathName&);
 
     WeightMatrix(Size rows, Size cols);
@@ -44,13 +45,14 @@ public:  // methods
 
     void validate(const char* when) const;
 
+    /// Save to a matrix file: the in-memory layout (as dump), padded to the page size, usable in place if mapped
+    void save(const eckit::PathName&) const;
+
     using SparseMatrix::cols;
     using SparseMatrix::rows;
 
     using SparseMatrix::footprint;
-    using SparseMatrix::load;
     using SparseMatrix::prune;
-    using SparseMatrix::save;
     using SparseMatrix::setIdentity;
 
     using SparseMatrix::begin;
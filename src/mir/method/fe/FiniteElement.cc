@@ -13,8 +13,8 @@
 #include "mir/method/fe/FiniteElement.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <forward_list>
 #include <limits>
 #include <map>
 #include <memory>
@@ -27,11 +27,14 @@
 
 #include "mir/caching/InMemoryMeshCache.h"
 #include "mir/param/MIRParametrisation.h"
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
+#include "mir/search/Tree.h"
+#include "mir/search/tree/TreeMemory.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Log.h"
 #include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 
 
@@ -51,32 +54,33 @@ static void init() {
 }
 
 using triplet_vector_t    = std::vector<WeightMatrix::Triplet>;
-using element_tree_t      = atlas::interpolation::method::ElemIndex3;
-using failed_projection_t = std::pair<size_t, PointLatLon>;
+using failed_projection_t = std::pair<size_t, size_t>;  // (point index, position in iteration order)
 
 
-struct element_t : std::vector<size_t> {
-    using vector::vector;
+struct element_t {
+    element_t(std::initializer_list<size_t> idx) : size(idx.size()) {
+        ASSERT(size <= index.size());
+        std::copy(idx.begin(), idx.end(), index.begin());
+    }
 
     element_t(const element_t&)            = delete;
     element_t(element_t&&)                 = delete;
     element_t& operator=(const element_t&) = delete;
     element_t& operator=(element_t&&)      = delete;
 
-    virtual ~element_t() = default;
-
-    virtual bool intersects(const atlas::interpolation::method::Ray&, double eps) = 0;
+    ~element_t() = default;
 
     void append_triplets(size_t i, size_t nbRealPoints, triplet_vector_t& t) const {
-        ASSERT(size() == weights.size());
+        const auto* first = index.data();
+        const auto* last  = first + size;
 
-        bool normalise = std::any_of(cbegin(), cend(), [nbRealPoints](size_t i) { return i >= nbRealPoints; });
+        bool normalise = std::any_of(first, last, [nbRealPoints](size_t i) { return i >= nbRealPoints; });
         if (normalise) {
             // sum all calculated weights for normalisation
             double sum = 0.;
             size_t n   = 0;
-            for (size_t j = 0; j < size(); ++j) {
-                if (operator[](j) < nbRealPoints) {
+            for (size_t j = 0; j < size; ++j) {
+                if (index[j] < nbRealPoints) {
                     sum += weights[j];
                     ++n;
                 }
@@ -87,9 +91,9 @@ struct element_t : std::vector<size_t> {
                 bool equitable = sum <= std::numeric_limits<double>::epsilon();
                 auto invSum    = 1. / (equitable ? double(n) : sum);
 
-                for (size_t j = 0; j < size() && 0 < n; ++j) {
-                    if (operator[](j) < nbRealPoints) {
-                        t.emplace_back(i, operator[](j), equitable ? invSum : (weights[j] * invSum));
+                for (size_t j = 0; j < size && 0 < n; ++j) {
+                    if (index[j] < nbRealPoints) {
+                        t.emplace_back(i, index[j], equitable ? invSum : (weights[j] * invSum));
                     }
                 }
             }
@@ -97,13 +101,16 @@ struct element_t : std::vector<size_t> {
             return;
         }
 
-        for (size_t j = 0; j < size(); ++j) {
-            t.emplace_back(i, operator[](j), weights[j]);
+        for (size_t j = 0; j < size; ++j) {
+            t.emplace_back(i, index[j], weights[j]);
         }
     }
 
-    std::vector<double>
-        weights;  //< weights (per element vertex) are the linear Lagrange function at u,v (barycentric coordinates)
+    // fixed capacity (up to quadrilaterals), so elements live on the stack
+    std::array<size_t, 4> index{};
+    std::array<double, 4> weights{};  //< weights (per element vertex) are the linear Lagrange function at u,v
+                                      //< (barycentric coordinates)
+    const size_t size;
 };
 
 
@@ -114,10 +121,10 @@ struct triag_t : element_t, atlas::interpolation::element::Triag3D {
                 atlas::PointXYZ{coords(i2, XYZCOORDS::XX), coords(i2, XYZCOORDS::YY), coords(i2, XYZCOORDS::ZZ)},
                 atlas::PointXYZ{coords(i3, XYZCOORDS::XX), coords(i3, XYZCOORDS::YY), coords(i3, XYZCOORDS::ZZ)}) {}
 
-    bool intersects(const atlas::interpolation::method::Ray& r, double eps) override {
+    bool intersects(const atlas::interpolation::method::Ray& r, double eps) {
         auto is = Triag3D::intersects(r, eps * std::sqrt(area()));
         if (is) {
-            weights.assign({1. - is.u - is.v, is.u, is.v});
+            weights = {1. - is.u - is.v, is.u, is.v, 0.};
             return true;
         }
         return false;
@@ -133,10 +140,10 @@ struct quad_t : element_t, atlas::interpolation::element::Quad3D {
                atlas::PointXYZ{coords(i3, XYZCOORDS::XX), coords(i3, XYZCOORDS::YY), coords(i3, XYZCOORDS::ZZ)},
                atlas::PointXYZ{coords(i4, XYZCOORDS::XX), coords(i4, XYZCOORDS::YY), coords(i4, XYZCOORDS::ZZ)}) {}
 
-    bool intersects(const atlas::interpolation::method::Ray& r, double eps) override {
+    bool intersects(const atlas::interpolation::method::Ray& r, double eps) {
         auto is = Quad3D::intersects(r, eps * std::sqrt(area()));
         if (is) {
-            weights.assign({(1. - is.u) * (1. - is.v), is.u * (1. - is.v), is.u * is.v, (1. - is.u) * is.v});
+            weights = {(1. - is.u) * (1. - is.v), is.u * (1. - is.v), is.u * is.v, (1. - is.u) * is.v};
             return true;
         }
         return false;
@@ -258,11 +265,24 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
     const auto& inMesh = atlasMesh(statistics, in);
 
 
-    // generate k-d tree with cell centres
-    std::unique_ptr<element_tree_t> eTree;
+    // generate k-d tree with cell centres (reentrant, queried concurrently)
+    std::unique_ptr<search::Tree> eTree;
     {
         trace::ResourceUsage timer("k-d tree: create");
-        eTree.reset(atlas::interpolation::method::create_element_centre_index(inMesh));
+
+        const auto centres = atlas::array::make_view<double, 2>(inMesh.cells().field("centre"));
+        const auto nbCells = size_t(inMesh.cells().size());
+        ASSERT(nbCells > 0);
+
+        std::vector<search::Tree::PointValueType> points;
+        points.reserve(nbCells);
+        for (size_t e = 0; e < nbCells; ++e) {
+            auto j = atlas::idx_t(e);
+            points.emplace_back(Point3(centres(j, 0), centres(j, 1), centres(j, 2)), e);
+        }
+
+        eTree.reset(new search::tree::TreeMemory(nbCells));
+        eTree->build(points);
     }
 
     double R = inMesh.metadata().getDouble("cell_longest_diagonal");
@@ -282,33 +302,54 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
         inNodes.metadata().has("NbRealPts") ? inNodes.metadata().get<size_t>("NbRealPts") : nbInputPoints;
 
 
-    // some statistics
-    size_t nbMaxElementsSearched   = 0;
-    size_t nbMinElementsSearched   = std::numeric_limits<size_t>::max();
-    size_t nbMaxProjectionAttempts = 0;
-    size_t nbProjections           = 0;
-    size_t nbFailures              = 0;
+    // output points to project, in iteration order
+    repres::Coordinates coord;
+    out.coordinates(coord);
+    const auto xyz = coord.points3D();
 
-    std::forward_list<failed_projection_t> failures;
-    triplet_vector_t weights_triplets;             // structure to fill-in sparse matrix
-    weights_triplets.reserve(nbOutputPoints * 4);  // preallocate space as if all elements where quads
 
+    // project per contiguous range, each with own statistics, failures and triplets
+    struct projection_t {
+        size_t nbMaxElementsSearched   = 0;
+        size_t nbMinElementsSearched   = std::numeric_limits<size_t>::max();
+        size_t nbMaxProjectionAttempts = 0;
+        size_t nbProjections           = 0;
+        std::vector<failed_projection_t> failures;
+        triplet_vector_t weights_triplets;  // structure to fill-in sparse matrix
+    };
 
-    {
-        trace::ProgressTimer progress("Projecting", nbOutputPoints, {"point"});
+    const auto ranges = util::parallel_ranges(coord.size(), util::parallel_threads(parametrisation_));
+    std::vector<projection_t> projections(ranges.size());
+
+    log << "FiniteElement: projecting " << Log::Pretty(coord.size(), {"point"}) << " using "
+        << Log::Pretty(ranges.size(), {"thread"}) << std::endl;
+
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        auto& local = projections[r];
+        local.weights_triplets.reserve((end - begin) * 4);  // preallocate space as if all elements where quads
+
+        // progress of the first range (all points if serial)
+        std::unique_ptr<trace::ProgressTimer> progress(
+            r == 0 ? new trace::ProgressTimer("Projecting", end - begin, {"point"}) : nullptr);
+
+        std::vector<search::Tree::PointValueType> closest;
 
         // iterate over output points
-        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next(); ++progress) {
-            if (inDomain.contains(it->pointRotated())) {
+        for (size_t i = begin; i < end; ++i) {
+            if (progress) {
+                ++(*progress);
+            }
+
+            if (inDomain.contains(coord.point(i))) {
 
                 // 3D projection, trying elements closest to p
-                Point3 p(it->point3D());
+                Point3 p(xyz[i]);
                 size_t nbProjectionAttempts = 0;
 
-                auto ip = it->index();
+                auto ip = coord.indices[i];
                 ASSERT(ip < nbOutputPoints);
 
-                auto closest = eTree->findInSphere(p, R);
+                eTree->findInSphere(p, R, closest);
 
                 atlas::interpolation::method::Ray ray(p.data());
 
@@ -329,7 +370,7 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
                          * - nb_cols == 4 implies quadrilateral
                          * - no other element is supported at the time
                          */
-                        const auto e = atlas::idx_t(close.value().payload());
+                        const auto e = atlas::idx_t(close.payload());
                         ASSERT(e < connectivity.rows());
 
                         auto idx = [e, nbInputPoints, &connectivity](atlas::idx_t j) {
@@ -339,33 +380,58 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
                         };
 
                         const auto nb_cols = connectivity.cols(e);
+                        if (nb_cols == 3) {
+                            triag_t elem(inCoords, idx(0), idx(1), idx(2));
+                            if ((success = elem.intersects(ray, eps))) {
+                                elem.append_triplets(ip, nbRealPts, local.weights_triplets);
+                            }
+                        }
+                        else if (nb_cols == 4) {
+                            quad_t elem(inCoords, idx(0), idx(1), idx(2), idx(3));
+                            if ((success = elem.intersects(ray, eps))) {
+                                elem.append_triplets(ip, nbRealPts, local.weights_triplets);
+                            }
+                        }
+                        else {
+                            NOTIMP;
+                        }
 
-                        std::unique_ptr<element_t> elem(
-                            nb_cols == 3   ? static_cast<element_t*>(new triag_t(inCoords, idx(0), idx(1), idx(2)))
-                            : nb_cols == 4 ? new quad_t(inCoords, idx(0), idx(1), idx(2), idx(3))
-                                           : NOTIMP);
-
-                        if (elem->intersects(ray, eps)) {
-                            elem->append_triplets(ip, nbRealPts, weights_triplets);
-                            success = true;
+                        if (success) {
                             break;
                         }
                     }
                 }
 
-                nbMaxElementsSearched   = std::max(nbMaxElementsSearched, closest.size());
-                nbMinElementsSearched   = std::min(nbMinElementsSearched, closest.size());
-                nbMaxProjectionAttempts = std::max(nbMaxProjectionAttempts, nbProjectionAttempts);
+                local.nbMaxElementsSearched   = std::max(local.nbMaxElementsSearched, closest.size());
+                local.nbMinElementsSearched   = std::min(local.nbMinElementsSearched, closest.size());
+                local.nbMaxProjectionAttempts = std::max(local.nbMaxProjectionAttempts, nbProjectionAttempts);
 
                 if (success) {
-                    ++nbProjections;
+                    ++local.nbProjections;
                 }
                 else if (projectionFail_ != ProjectionFail::missingValue) {
-                    failures.emplace_front(ip, it->pointUnrotated());
-                    ++nbFailures;
+                    local.failures.emplace_back(ip, i);
                 }
             }
         }
+    });
+
+
+    // some statistics
+    size_t nbMaxElementsSearched   = 0;
+    size_t nbMinElementsSearched   = std::numeric_limits<size_t>::max();
+    size_t nbMaxProjectionAttempts = 0;
+    size_t nbProjections           = 0;
+    size_t nbFailures              = 0;
+    size_t nbTriplets              = 0;
+
+    for (const auto& local : projections) {
+        nbMaxElementsSearched   = std::max(nbMaxElementsSearched, local.nbMaxElementsSearched);
+        nbMinElementsSearched   = std::min(nbMinElementsSearched, local.nbMinElementsSearched);
+        nbMaxProjectionAttempts = std::max(nbMaxProjectionAttempts, local.nbMaxProjectionAttempts);
+        nbProjections += local.nbProjections;
+        nbFailures += local.failures.size();
+        nbTriplets += local.weights_triplets.size();
     }
 
     log << "Projected " << Log::Pretty(nbProjections) << " of " << Log::Pretty(nbOutputPoints, {"point"}) << "\n"
@@ -377,19 +443,33 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
         std::ostringstream msg;
         msg << "Failed to project " << Log::Pretty(nbFailures, {"point"});
         log << msg.str() << ":";
+
+        repres::Coordinates unrotated;
+        out.coordinates(unrotated, false);
+
         size_t count = 0;
-        for (const auto& f : failures) {
-            log << "\n\tpoint " << f.first << " " << f.second;
-            if (++count > nbMaxFailures) {
-                log << "\n\t...";
-                break;
+        for (const auto& local : projections) {
+            for (auto f = local.failures.begin(); f != local.failures.end() && count <= nbMaxFailures; ++f, ++count) {
+                log << "\n\tpoint " << f->first << " " << unrotated.pointLatLon(f->second);
             }
         }
+        if (count < nbFailures) {
+            log << "\n\t...";
+        }
         log << std::endl;
         throw exception::SeriousBug(msg.str());
     }
 
 
+    // merge in range order, so the result is the same as serial assembly
+    triplet_vector_t weights_triplets;
+    weights_triplets.reserve(nbTriplets);
+    for (auto& local : projections) {
+        weights_triplets.insert(weights_triplets.end(), local.weights_triplets.begin(), local.weights_triplets.end());
+        triplet_vector_t().swap(local.weights_triplets);
+    }
+
+
     // fill sparse matrix
     ASSERT_NONEMPTY_INTERPOLATION("FiniteElement", !weights_triplets.empty());
     W.setFromTriplets(weights_triplets);
@@ -13,7 +13,6 @@
 #include "mir/method/gridbox/GridBoxMethod.h"
 
 #include <algorithm>
-#include <forward_list>
 #include <sstream>
 #include <vector>
 
@@ -21,13 +20,15 @@
 #include "eckit/utils/MD5.h"
 
 #include "mir/param/MIRParametrisation.h"
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
 #include "mir/search/PointSearch.h"
+#include "mir/util/Angles.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/GridBox.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
 
@@ -35,7 +36,140 @@
 namespace mir::method::gridbox {
 
 
-GridBoxMethod::GridBoxMethod(const param::MIRParametrisation& parametrisation) : MethodWeighted(parametrisation) {
+namespace {
+
+
+struct GridBoxRow {
+    size_t begin;
+    size_t end;
+    double north;
+    double south;
+};
+
+
+/// Rows of grid boxes (contiguous in index order, of the same north/south edges, west to east without overlapping and
+/// spanning at most 360 degrees), from north to south without overlapping (false if the grid boxes are not so)
+bool grid_box_rows(const std::vector<util::GridBox>& boxes, std::vector<GridBoxRow>& rows) {
+    rows.clear();
+
+    for (size_t i = 0, j = 0; i < boxes.size(); i = j) {
+        const auto& first = boxes[i];
+        for (j = i + 1; j < boxes.size() && boxes[j].north() == first.north() && boxes[j].south() == first.south();
+             ++j) {
+            if (!(boxes[j - 1].east() <= boxes[j].west())) {
+                return false;
+            }
+        }
+
+        if (!(boxes[j - 1].east() <= first.west() + 360.) || (!rows.empty() && !(first.north() <= rows.back().south))) {
+            return false;
+        }
+
+        rows.push_back({i, j, first.north(), first.south()});
+    }
+
+    return !rows.empty();
+}
+
+
+/// Intersect output with input grid boxes row by row (latitude bands), in parallel over output rows
+void intersect_rows(const std::vector<util::GridBox>& inBoxes, const std::vector<GridBoxRow>& inRows,
+                    const std::vector<util::GridBox>& outBoxes, const std::vector<GridBoxRow>& outRows,
+                    size_t threads, std::vector<WeightMatrix::Triplet>& weights_triplets,
+                    std::vector<size_t>& failures) {
+    struct intersection_t {
+        std::vector<WeightMatrix::Triplet> weights_triplets;
+        std::vector<size_t> failures;
+    };
+
+    const auto ranges = util::parallel_ranges(outRows.size(), threads);
+    std::vector<intersection_t> intersections(ranges.size());
+
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        auto& local = intersections[r];
+        std::vector<WeightMatrix::Triplet> triplets;
+
+        for (size_t row = begin; row < end; ++row) {
+            const auto& outRow = outRows[row];
+
+            // input rows overlapping in latitude (by decreasing latitude)
+            auto inRow = std::partition_point(inRows.begin(), inRows.end(),
+                                              [&](const GridBoxRow& in) { return in.south >= outRow.north; });
+
+            for (auto i = outRow.begin; i < outRow.end; ++i) {
+                const auto& box = outBoxes[i];
+                double area     = box.area();
+                ASSERT(area > 0.);
+
+                triplets.clear();
+                double sumSmallAreas = 0.;
+                bool areaMatch       = false;
+
+                // stop at the first area match, as the k-d tree search does
+                for (auto in = inRow; !areaMatch && in != inRows.end() && in->north > outRow.south; ++in) {
+
+                    // input boxes from the one containing the west edge (normalised), eastwards until the east edge
+                    const auto* first = inBoxes.data() + in->begin;
+                    const auto n      = in->end - in->begin;
+
+                    const auto w = util::normalise_longitude(box.west(), first->west());
+                    const auto e = w + (box.east() - box.west());
+
+                    auto k = static_cast<size_t>(
+                        std::upper_bound(first, first + n, w,
+                                         [](double w, const util::GridBox& b) { return w < b.west(); }) -
+                        first);
+                    ASSERT(0 < k && k <= n);
+
+                    double shift = 0.;
+                    for (size_t c = 0, j = k - 1; !areaMatch && c < n; ++c, j = (j + 1) % n) {
+                        if (c > 0 && j == 0) {
+                            shift += 360.;
+                        }
+
+                        if (!(first[j].west() + shift < e)) {
+                            break;
+                        }
+
+                        auto smallBox = first[j];
+                        if (box.intersects(smallBox)) {
+                            double smallArea = smallBox.area();
+                            ASSERT(smallArea > 0.);
+
+                            triplets.emplace_back(WeightMatrix::Triplet(i, in->begin + j, smallArea / area));
+                            sumSmallAreas += smallArea;
+
+                            areaMatch = eckit::types::is_approximately_equal(area, sumSmallAreas, 1. /*m^2*/);
+                        }
+                    }
+                }
+
+                // insert the interpolant weights into the global (sparse) interpolant matrix
+                if (areaMatch) {
+                    local.weights_triplets.insert(local.weights_triplets.end(), triplets.begin(), triplets.end());
+                }
+                else {
+                    local.failures.emplace_back(i);
+                }
+            }
+        }
+    });
+
+    // merge in range order
+    for (auto& local : intersections) {
+        weights_triplets.insert(weights_triplets.end(), local.weights_triplets.begin(), local.weights_triplets.end());
+        failures.insert(failures.end(), local.failures.begin(), local.failures.end());
+    }
+}
+
+
+}  // namespace
+
+
+GridBoxMethod::GridBoxMethod(const param::MIRParametrisation& parametrisation) :
+    MethodWeighted(parametrisation), rows_(true) {
+    parametrisation.get("grid-box-rows", rows_);
+
     if (parametrisation.userParametrisation().has("rotation") ||
         parametrisation.fieldParametrisation().has("rotation")) {
         throw exception::UserError("GridBoxMethod: rotated input/output not supported");
@@ -48,7 +182,7 @@ GridBoxMethod::~GridBoxMethod() = default;
 
 bool GridBoxMethod::sameAs(const Method& other) const {
     const auto* o = dynamic_cast<const GridBoxMethod*>(&other);
-    return (o != nullptr) && name() == o->name() && MethodWeighted::sameAs(*o);
+    return (o != nullptr) && name() == o->name() && rows_ == o->rows_ && MethodWeighted::sameAs(*o);
 }
 
 
@@ -72,8 +206,7 @@ void GridBoxMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
     // init structure used to fill in sparse matrix
     // TODO: triplets, really? why not writing to the matrix directly?
     std::vector<WeightMatrix::Triplet> weights_triplets;
-    std::vector<WeightMatrix::Triplet> triplets;
-    std::vector<search::PointSearch::PointValueType> closest;
+    std::vector<size_t> failures;  // (point index)
 
 
     // set input and output grid boxes
@@ -93,31 +226,48 @@ void GridBoxMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
 
     const GridBoxes inBoxes(in);
     const GridBoxes outBoxes(out);
-    const auto R = inBoxes.getLongestGridBoxDiagonal() + outBoxes.getLongestGridBoxDiagonal();
 
-    size_t nbFailures           = 0;
-    using failed_intersection_t = std::pair<size_t, PointLatLon>;
-    std::forward_list<failed_intersection_t> failures;
 
+    // structured grid boxes (in latitude rows) are intersected by a sweep over rows, otherwise by a k-d tree search
+    std::vector<GridBoxRow> inRows;
+    std::vector<GridBoxRow> outRows;
 
-    // set input k-d tree for grid boxes indices
-    std::unique_ptr<search::PointSearch> tree;
-    {
-        trace::ResourceUsage usage("GridBoxMethod::assemble create k-d tree");
-        tree = std::make_unique<search::PointSearch>(parametrisation_, in);
+    if (rows_ && grid_box_rows(inBoxes, inRows) && grid_box_rows(outBoxes, outRows)) {
+        trace::ResourceUsage usage("GridBoxMethod::assemble intersect rows");
+        log << "GridBoxMethod: intersect " << Log::Pretty(outRows.size(), {"row"}) << " from "
+            << Log::Pretty(inRows.size(), {"row"}) << std::endl;
+
+        intersect_rows(inBoxes, inRows, outBoxes, outRows, util::parallel_threads(parametrisation_),
+                       weights_triplets, failures);
     }
+    else {
+        std::vector<WeightMatrix::Triplet> triplets;
+        std::vector<search::PointSearch::PointValueType> closest;
+
+        const auto R = inBoxes.getLongestGridBoxDiagonal() + outBoxes.getLongestGridBoxDiagonal();
+
+
+        // set input k-d tree for grid boxes indices
+        std::unique_ptr<search::PointSearch> tree;
+        {
+            trace::ResourceUsage usage("GridBoxMethod::assemble create k-d tree");
+            tree = std::make_unique<search::PointSearch>(parametrisation_, in);
+        }
 
-    {
         trace::ProgressTimer progress("Intersecting", outBoxes.size(), gridBoxes);
 
-        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
+        repres::Coordinates coord;
+        out.coordinates(coord);
+        const auto xyz = coord.points3D();
+
+        for (size_t n = 0; n < coord.size(); ++n) {
             if (++progress) {
                 log << *tree << std::endl;
             }
 
 
             // lookup
-            tree->closestWithinRadius(it->point3D(), R, closest);
+            tree->closestWithinRadius(xyz[n], R, closest);
             ASSERT(!closest.empty());
 
 
@@ -125,7 +275,7 @@ void GridBoxMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
             triplets.clear();
             triplets.reserve(closest.size());
 
-            auto i          = it->index();
+            auto i          = coord.indices[n];
             const auto& box = outBoxes.at(i);
             double area     = box.area();
             ASSERT(area > 0.);
@@ -155,19 +305,28 @@ void GridBoxMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
                 std::copy(triplets.begin(), triplets.end(), std::back_inserter(weights_triplets));
             }
             else {
-                ++nbFailures;
-                failures.push_front({i, it->pointUnrotated()});
+                failures.emplace_back(i);
             }
         }
     }
     log << "Intersected " << Log::Pretty(weights_triplets.size(), gridBoxes) << std::endl;
 
-    if (nbFailures > 0) {
+    if (!failures.empty()) {
         auto& warning = Log::warning();
-        warning << "Failed to intersect " << Log::Pretty(nbFailures, gridBoxes) << ":";
+        warning << "Failed to intersect " << Log::Pretty(failures.size(), gridBoxes) << ":";
+
+        repres::Coordinates unrotated;
+        out.coordinates(unrotated, false);
+
+        std::vector<size_t> position(unrotated.size());
+        for (size_t n = 0; n < unrotated.size(); ++n) {
+            ASSERT(unrotated.indices[n] < position.size());
+            position[unrotated.indices[n]] = n;
+        }
+
         size_t count = 0;
         for (const auto& f : failures) {
-            warning << "\n\tpoint " << f.first << " " << f.second;
+            warning << "\n\tpoint " << f << " " << unrotated.pointLatLon(position[f]);
             if (++count > 10) {
                 warning << "\n\t...";
                 break;
@@ -186,11 +345,12 @@ void GridBoxMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
 void GridBoxMethod::hash(eckit::MD5& md5) const {
     MethodWeighted::hash(md5);
     md5.add(name());
+    md5 << rows_;
 }
 
 
 void GridBoxMethod::print(std::ostream& out) const {
-    out << "GridBoxMethod[name=" << name() << ",";
+    out << "GridBoxMethod[name=" << name() << ",rows=" << rows_ << ",";
     MethodWeighted::print(out);
     out << "]";
 }
@@ -70,7 +70,8 @@ protected:
 
 private:
     // -- Members
-    // None
+
+    bool rows_;
 
     // -- Methods
     // None
@@ -13,18 +13,18 @@
 #include "mir/method/knn/KNearestNeighbours.h"
 
 #include <algorithm>
-#include <memory>
 
 #include "eckit/utils/MD5.h"
 
 #include "mir/method/knn/distance/DistanceWeighting.h"
 #include "mir/method/knn/pick/Pick.h"
 #include "mir/param/MIRParametrisation.h"
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
 
@@ -71,6 +71,14 @@ void KNearestNeighbours::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
     const auto& inDomain = in.domain();
     pick.distance(in);
 
+    // parallel assembly, if picking and weighting allow it
+    if (pick.parallel() && distanceWeighting.parallel()) {
+        if (auto threads = util::parallel_threads(parametrisation_); threads > 1) {
+            assemble(W, in, out, sptree, pick, distanceWeighting, threads);
+            return;
+        }
+    }
+
 
     // init structure used to fill in sparse matrix
     std::vector<WeightMatrix::Triplet> weights_triplets;
@@ -79,12 +87,16 @@ void KNearestNeighbours::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
     std::vector<search::PointSearch::PointValueType> closest;
     std::vector<WeightMatrix::Triplet> triplets;
 
+    repres::Coordinates coord;
+    out.coordinates(coord);
+    const auto xyz = coord.points3D();
+
     {
         trace::ProgressTimer progress("Locating", nbOutputPoints, {"point"});
         double search = 0;
         double insert = 0;
 
-        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
+        for (size_t i = 0; i < coord.size(); ++i) {
             if (++progress) {
                 log << "KNearestNeighbours: k-d tree"
                        "\n"
@@ -100,10 +112,10 @@ void KNearestNeighbours::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
                 search = insert = 0;
             }
 
-            if (inDomain.contains(it->pointRotated())) {
+            if (inDomain.contains(coord.point(i))) {
 
                 // 3D point to lookup
-                Point3 p(it->point3D());
+                const auto& p = xyz[i];
 
                 // search
                 {
@@ -116,7 +128,7 @@ void KNearestNeighbours::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
                 }
 
                 // calculate weights
-                auto ip = it->index();
+                auto ip = coord.indices[i];
                 ASSERT(ip < nbOutputPoints);
 
                 distanceWeighting(ip, p, closest, triplets);
@@ -142,6 +154,82 @@ void KNearestNeighbours::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
 }
 
 
+void KNearestNeighbours::assemble(WeightMatrix& W, const repres::Representation& in,
+                                  const repres::Representation& out, const search::PointSearch& sptree,
+                                  const pick::Pick& pick, const distance::DistanceWeighting& distanceWeighting,
+                                  size_t threads) const {
+    trace::Timer timer("KNearestNeighbours::assemble (parallel)");
+
+    const size_t nbOutputPoints = out.numberOfPoints();
+    const auto& inDomain        = in.domain();
+
+
+    // output points to locate, in iteration order
+    std::vector<size_t> indices;
+    std::vector<Point3> points;
+    {
+        repres::Coordinates coord;
+        out.coordinates(coord);
+        auto xyz = coord.points3D();
+
+        indices.reserve(coord.size());
+        points.reserve(coord.size());
+
+        for (size_t i = 0; i < coord.size(); ++i) {
+            if (inDomain.contains(coord.point(i))) {
+                ASSERT(coord.indices[i] < nbOutputPoints);
+                indices.emplace_back(coord.indices[i]);
+                points.emplace_back(xyz[i]);
+            }
+        }
+    }
+
+
+    // locate and weight per contiguous range, each with own triplets
+    const auto ranges = util::parallel_ranges(points.size(), threads);
+    std::vector<std::vector<WeightMatrix::Triplet>> weights_triplets(ranges.size());
+
+    Log::debug() << "KNearestNeighbours: locating " << Log::Pretty(points.size(), {"point"}) << " using "
+                 << Log::Pretty(ranges.size(), {"thread"}) << std::endl;
+
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        auto& local = weights_triplets[r];
+        local.reserve((end - begin) * pick.n());
+
+        std::vector<search::PointSearch::PointValueType> closest;
+        std::vector<WeightMatrix::Triplet> triplets;
+
+        for (size_t i = begin; i < end; ++i) {
+            pick.pick(sptree, points[i], closest);
+            if (!closest.empty()) {
+                distanceWeighting(indices[i], points[i], closest, triplets);
+                ASSERT(!triplets.empty());
+                local.insert(local.end(), triplets.begin(), triplets.end());
+            }
+        }
+    });
+
+
+    // merge in range order, so the result is the same as serial assembly
+    size_t size = 0;
+    for (const auto& local : weights_triplets) {
+        size += local.size();
+    }
+
+    ASSERT_NONEMPTY_INTERPOLATION("KNearestNeighbours", size > 0);
+
+    std::vector<WeightMatrix::Triplet> merged;
+    merged.reserve(size);
+    for (auto& local : weights_triplets) {
+        merged.insert(merged.end(), local.begin(), local.end());
+        std::vector<WeightMatrix::Triplet>().swap(local);
+    }
+
+    // fill-in sparse matrix
+    W.setFromTriplets(merged);
+}
+
+
 void KNearestNeighbours::print(std::ostream& out) const {
     out << "KNearestNeighbours[";
     MethodWeighted::print(out);
@@ -17,6 +17,10 @@
 #include "mir/method/MethodWeighted.h"
 
 
+namespace mir::search {
+class PointSearch;
+}  // namespace mir::search
+
 namespace mir::method::knn {
 namespace distance {
 class DistanceWeighting;
@@ -48,6 +52,10 @@ protected:
     bool sameAs(const Method&) const override = 0;
 
 private:
+    void assemble(WeightMatrix&, const repres::Representation& in, const repres::Representation& out,
+                  const search::PointSearch&, const pick::Pick&, const distance::DistanceWeighting&,
+                  size_t threads) const;
+
     void print(std::ostream&) const override;
 
     const char* name() const override = 0;
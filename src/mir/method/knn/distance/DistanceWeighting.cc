@@ -37,6 +37,11 @@ DistanceWeighting::DistanceWeighting() = default;
 DistanceWeighting::~DistanceWeighting() = default;
 
 
+bool DistanceWeighting::parallel() const {
+    return true;
+}
+
+
 DistanceWeightingFactory::DistanceWeightingFactory(const std::string& name) : name_(name) {
     util::call_once(once, init);
     util::lock_guard<util::recursive_mutex> lock(*local_mutex);
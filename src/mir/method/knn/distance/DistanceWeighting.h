@@ -38,6 +38,9 @@ public:
 
     virtual bool sameAs(const DistanceWeighting&) const = 0;
 
+    /// If weighting can be called concurrently (default, used for parallel assembly)
+    virtual bool parallel() const;
+
     virtual void hash(eckit::MD5&) const = 0;
 
 private:
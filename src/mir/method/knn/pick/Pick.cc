@@ -42,6 +42,11 @@ void Pick::distance(const repres::Representation& /*unused*/) const {
 }
 
 
+bool Pick::parallel() const {
+    return true;
+}
+
+
 PickFactory::PickFactory(const std::string& name) : name_(name) {
     util::call_once(once, init);
     util::lock_guard<util::recursive_mutex> lock(*local_mutex);
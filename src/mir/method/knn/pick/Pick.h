@@ -46,6 +46,9 @@ public:
 
     virtual void distance(const repres::Representation&) const;
 
+    /// If picking can be called concurrently (default, used for parallel assembly)
+    virtual bool parallel() const;
+
 private:
     virtual void print(std::ostream&) const = 0;
 
@@ -54,6 +54,12 @@ void Sample::pick(const search::PointSearch& tree, const Point3& p, Pick::neighb
 }
 
 
+// std::rand() is not thread-safe, and sampling must be reproducible
+bool Sample::parallel() const {
+    return false;
+}
+
+
 size_t Sample::n() const {
     return nClosest_;
 }
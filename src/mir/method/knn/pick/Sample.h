@@ -24,6 +24,7 @@ struct Sample : Pick {
     size_t n() const override;
     bool sameAs(const Pick&) const override;
     void hash(eckit::MD5&) const override;
+    bool parallel() const override;
 
 private:
     void print(std::ostream&) const override;
@@ -32,6 +32,12 @@ void SortedSample::pick(const search::PointSearch& tree, const Point3& p, Pick::
               });
 }
 
+
+bool SortedSample::parallel() const {
+    return sample_.parallel();
+}
+
+
 size_t SortedSample::n() const {
     return sample_.n();
 }
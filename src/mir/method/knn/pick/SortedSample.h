@@ -25,6 +25,7 @@ struct SortedSample : Pick {
     size_t n() const override;
     bool sameAs(const Pick&) const override;
     void hash(eckit::MD5&) const override;
+    bool parallel() const override;
 
 private:
     void print(std::ostream&) const override;
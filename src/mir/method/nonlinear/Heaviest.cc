@@ -56,6 +56,28 @@ bool Heaviest::treatment(MethodWeighted::Matrix& /*A*/, MethodWeighted::WeightMa
 }
 
 
+bool Heaviest::treatmentRow(std::vector<WeightMatrix::Scalar>& weights, const std::vector<double>& /*values*/,
+                            const double& /*missingValue*/) const {
+    // find heaviest-weighted column in row
+    size_t heaviest_index  = 0;
+    double heaviest_weight = -1.;
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if (heaviest_weight < weights[i]) {
+            heaviest_weight = weights[i];
+            heaviest_index  = i;
+        }
+    }
+
+    // set the heaviest-weighted column in row to 1, other entries to 0
+    for (size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = i == heaviest_index ? 1. : 0.;
+    }
+
+    return true;
+}
+
+
 bool Heaviest::sameAs(const NonLinear& other) const {
     const auto* o = dynamic_cast<const Heaviest*>(&other);
     return (o != nullptr);
@@ -90,6 +90,47 @@ bool MissingIfAllMissing::treatment(MethodWeighted::Matrix& /*A*/, MethodWeighte
 }
 
 
+bool MissingIfAllMissing::treatmentRow(std::vector<WeightMatrix::Scalar>& weights, const std::vector<double>& values,
+                                       const double& missingValue) const {
+    ASSERT(weights.size() == values.size());
+    const auto N_entries = weights.size();
+
+    // count missing values, accumulate weights (disregarding missing values)
+    size_t i_missing = 0;
+    size_t N_missing = 0;
+    double sum       = 0.;
+
+    for (size_t i = 0; i < N_entries; ++i) {
+        if (values[i] == missingValue) {
+            ++N_missing;
+            i_missing = i;
+        }
+        else {
+            sum += weights[i];
+        }
+    }
+
+    if (N_missing == 0) {
+        return false;
+    }
+
+    // weights redistribution, as in treatment()
+    if (N_missing == N_entries || eckit::types::is_approximately_equal(sum, 0.)) {
+        for (size_t i = 0; i < N_entries; ++i) {
+            weights[i] = i == i_missing ? 1. : 0.;
+        }
+    }
+    else {
+        const double factor = 1. / sum;
+        for (size_t i = 0; i < N_entries; ++i) {
+            weights[i] = values[i] == missingValue ? 0. : (factor * weights[i]);
+        }
+    }
+
+    return true;
+}
+
+
 bool MissingIfAllMissing::sameAs(const NonLinear& other) const {
     const auto* o = dynamic_cast<const MissingIfAllMissing*>(&other);
     return (o != nullptr);
@@ -72,6 +72,32 @@ bool MissingIfAnyMissing::treatment(MethodWeighted::Matrix& /*A*/, MethodWeighte
 }
 
 
+bool MissingIfAnyMissing::treatmentRow(std::vector<WeightMatrix::Scalar>& weights, const std::vector<double>& values,
+                                       const double& missingValue) const {
+    ASSERT(weights.size() == values.size());
+    const auto N_entries = weights.size();
+
+    // find (last) missing value
+    size_t i_missing = N_entries;
+    for (size_t i = 0; i < N_entries; ++i) {
+        if (values[i] == missingValue) {
+            i_missing = i;
+        }
+    }
+
+    if (i_missing == N_entries) {
+        return false;
+    }
+
+    // if any values in row are missing, force missing value
+    for (size_t i = 0; i < N_entries; ++i) {
+        weights[i] = i == i_missing ? 1. : 0.;
+    }
+
+    return true;
+}
+
+
 bool MissingIfAnyMissing::sameAs(const NonLinear& other) const {
     const auto* o = dynamic_cast<const MissingIfAnyMissing*>(&other);
     return (o != nullptr);
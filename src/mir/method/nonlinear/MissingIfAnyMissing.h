@@ -24,11 +24,15 @@ struct MissingIfAnyMissing : NonLinear {
 private:
     bool treatment(MethodWeighted::Matrix& A, MethodWeighted::WeightMatrix& W, MethodWeighted::Matrix& B,
                    const MIRValuesVector&, const double& missingValue) const override;
+    bool treatmentRow(std::vector<WeightMatrix::Scalar>& weights, const std::vector<double>& values,
+                      const double& missingValue) const override;
     bool sameAs(const NonLinear&) const override;
     void print(std::ostream&) const override;
     void hash(eckit::MD5&) const override;
 
     bool modifiesMatrix(bool fieldHasMissingValues) const override { return fieldHasMissingValues; }
+    bool rowWise() const override { return true; }
+    bool gatherInvariant() const override { return true; }
 };
 
 
@@ -95,6 +95,56 @@ bool MissingIfHeaviestMissing::treatment(MethodWeighted::Matrix& /*A*/, MethodWe
 }
 
 
+bool MissingIfHeaviestMissing::treatmentRow(std::vector<WeightMatrix::Scalar>& weights,
+                                            const std::vector<double>& values, const double& missingValue) const {
+    ASSERT(weights.size() == values.size());
+    const auto N_entries = weights.size();
+
+    // count missing values, accumulate weights (disregarding missing values) and find maximum weight in row
+    size_t i_missing         = 0;
+    size_t N_missing         = 0;
+    double sum               = 0.;
+    double heaviest          = -1.;
+    bool heaviest_is_missing = false;
+
+    for (size_t i = 0; i < N_entries; ++i) {
+        const bool miss = values[i] == missingValue;
+
+        if (miss) {
+            ++N_missing;
+            i_missing = i;
+        }
+        else {
+            sum += weights[i];
+        }
+
+        if (heaviest < weights[i]) {
+            heaviest            = weights[i];
+            heaviest_is_missing = miss;
+        }
+    }
+
+    if (N_missing == 0) {
+        return false;
+    }
+
+    // weights redistribution, as in treatment()
+    if (N_missing == N_entries || heaviest_is_missing || eckit::types::is_approximately_equal(sum, 0.)) {
+        for (size_t i = 0; i < N_entries; ++i) {
+            weights[i] = i == i_missing ? 1. : 0.;
+        }
+    }
+    else {
+        const double factor = 1. / sum;
+        for (size_t i = 0; i < N_entries; ++i) {
+            weights[i] = values[i] == missingValue ? 0. : (factor * weights[i]);
+        }
+    }
+
+    return true;
+}
+
+
 bool MissingIfHeaviestMissing::sameAs(const NonLinear& other) const {
     const auto* o = dynamic_cast<const MissingIfHeaviestMissing*>(&other);
     return (o != nullptr);
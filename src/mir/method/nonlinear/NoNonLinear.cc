@@ -32,6 +32,13 @@ bool NoNonLinear::treatment(MethodWeighted::Matrix& /*A*/, MethodWeighted::Weigh
 }
 
 
+bool NoNonLinear::treatmentRow(std::vector<WeightMatrix::Scalar>& /*weights*/, const std::vector<double>& /*values*/,
+                               const double& /*missingValue*/) const {
+    // no non-linear treatment
+    return false;
+}
+
+
 bool NoNonLinear::sameAs(const NonLinear& other) const {
     const auto* o = dynamic_cast<const NoNonLinear*>(&other);
     return (o != nullptr);
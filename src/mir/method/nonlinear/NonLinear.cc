@@ -13,6 +13,7 @@
 #include "mir/method/nonlinear/NonLinear.h"
 
 #include <map>
+#include <sstream>
 
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
@@ -37,6 +38,14 @@ NonLinear::NonLinear(const param::MIRParametrisation& /*unused*/) {}
 NonLinear::~NonLinear() = default;
 
 
+bool NonLinear::treatmentRow(std::vector<WeightMatrix::Scalar>& /*weights*/, const std::vector<double>& /*values*/,
+                             const double& /*missingValue*/) const {
+    std::ostringstream os;
+    os << "NonLinear::treatmentRow() not implemented for " << *this;
+    throw exception::SeriousBug(os.str());
+}
+
+
 NonLinearFactory::NonLinearFactory(const std::string& name) : name_(name) {
     util::call_once(once, init);
     util::lock_guard<util::recursive_mutex> lock(*local_mutex);
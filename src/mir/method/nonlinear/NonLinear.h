@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #include "mir/method/MethodWeighted.h"
 
@@ -57,6 +58,17 @@ public:
 
     virtual bool modifiesMatrix(bool fieldHasMissingValues) const = 0;
 
+    /// Update one matrix row (weights copy) to account for non-linearities, given the row input values; allows
+    /// applying the treatment on the fly, without copying the matrix (only if rowWise())
+    virtual bool treatmentRow(std::vector<WeightMatrix::Scalar>& weights, const std::vector<double>& values,
+                              const double& missingValue) const;
+
+    virtual bool rowWise() const { return false; }
+
+    /// If rows of a single unit weight are left unchanged (interpolation is a gather of the input values, missing or
+    /// not), so such matrices need no treatment
+    virtual bool gatherInvariant() const { return false; }
+
 private:
     virtual void print(std::ostream&) const = 0;
 
@@ -104,6 +104,59 @@ bool SimulateMissingValue::treatment(MethodWeighted::Matrix& /*A*/, MethodWeight
 }
 
 
+bool SimulateMissingValue::treatmentRow(std::vector<WeightMatrix::Scalar>& weights, const std::vector<double>& values,
+                                        const double& /*ignored*/) const {
+    using eckit::types::is_approximately_equal;
+    auto missingValue = [this](double value) { return is_approximately_equal(value, missingValue_, epsilon_); };
+
+    ASSERT(weights.size() == values.size());
+    const auto N_entries = weights.size();
+
+    // count missing values, accumulate weights (disregarding missing values) and find maximum weight in row
+    size_t i_missing         = 0;
+    size_t N_missing         = 0;
+    double sum               = 0.;
+    double heaviest          = -1.;
+    bool heaviest_is_missing = false;
+
+    for (size_t i = 0; i < N_entries; ++i) {
+        const bool miss = missingValue(values[i]);
+
+        if (miss) {
+            ++N_missing;
+            i_missing = i;
+        }
+        else {
+            sum += weights[i];
+        }
+
+        if (heaviest < weights[i]) {
+            heaviest            = weights[i];
+            heaviest_is_missing = miss;
+        }
+    }
+
+    if (N_missing == 0) {
+        return false;
+    }
+
+    // weights redistribution, as in treatment()
+    if (N_missing == N_entries || heaviest_is_missing || is_approximately_equal(sum, 0.)) {
+        for (size_t i = 0; i < N_entries; ++i) {
+            weights[i] = i == i_missing ? 1. : 0.;
+        }
+    }
+    else {
+        const double factor = 1. / sum;
+        for (size_t i = 0; i < N_entries; ++i) {
+            weights[i] = missingValue(values[i]) ? 0. : (factor * weights[i]);
+        }
+    }
+
+    return true;
+}
+
+
 bool SimulateMissingValue::sameAs(const NonLinear& other) const {
     const auto* o = dynamic_cast<const SimulateMissingValue*>(&other);
     return (o != nullptr) && eckit::types::is_approximately_equal(missingValue_, o->missingValue_) &&
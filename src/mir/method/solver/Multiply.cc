@@ -12,6 +12,7 @@
 
 #include "mir/method/solver/Multiply.h"
 
+#include <algorithm>
 #include <ostream>
 #include <sstream>
 
@@ -19,7 +20,9 @@
 #include "eckit/linalg/Vector.h"
 #include "eckit/utils/MD5.h"
 
+#include "mir/method/nonlinear/NonLinear.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/Parallel.h"
 
 
 namespace mir::method::solver {
@@ -49,6 +52,51 @@ void Multiply::solve(const MethodWeighted::Matrix& A, const MethodWeighted::Weig
 }
 
 
+void Multiply::solve(const MethodWeighted::Matrix& A, const MethodWeighted::WeightMatrix& W, MethodWeighted::Matrix& B,
+                     const double& missingValue, const MIRValuesVector& values,
+                     const std::vector<std::unique_ptr<const nonlinear::NonLinear>>& nonLinear, size_t threads) const {
+    ASSERT(A.rows() == W.cols());
+    ASSERT(B.rows() == W.rows());
+    ASSERT(A.cols() == B.cols());
+    ASSERT(values.size() == W.cols());
+    ASSERT(std::all_of(nonLinear.begin(), nonLinear.end(), [](const auto& n) { return n->rowWise(); }));
+
+    const auto* outer = W.outer();
+    const auto* inner = W.inner();
+    const auto* data  = W.data();
+
+    // rows are treated in a per-thread scratch buffer (weights and input values), leaving the matrix unmodified
+    const auto ranges = util::parallel_ranges(W.rows(), threads);
+    util::parallel_for(ranges, [&](size_t /*unused*/, size_t begin, size_t end) {
+        std::vector<WeightMatrix::Scalar> weights;
+        std::vector<double> rowValues;
+
+        for (auto r = begin; r < end; ++r) {
+            const auto k0 = size_t(outer[r]);
+            const auto k1 = size_t(outer[r + 1]);
+
+            weights.assign(data + k0, data + k1);
+            rowValues.resize(k1 - k0);
+            for (auto k = k0; k < k1; ++k) {
+                rowValues[k - k0] = values[size_t(inner[k])];
+            }
+
+            for (const auto& n : nonLinear) {
+                n->treatmentRow(weights, rowValues, missingValue);
+            }
+
+            for (WeightMatrix::Size j = 0; j < A.cols(); ++j) {
+                double b = 0.;
+                for (auto k = k0; k < k1; ++k) {
+                    b += weights[k - k0] * A(size_t(inner[k]), j);
+                }
+                B(r, j) = b;
+            }
+        }
+    });
+}
+
+
 bool Multiply::sameAs(const Solver& other) const {
     return (dynamic_cast<const Multiply*>(&other) != nullptr);
 }
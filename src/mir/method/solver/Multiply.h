@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "mir/method/solver/Solver.h"
 
 
@@ -19,6 +22,10 @@ namespace eckit::linalg {
 class LinearAlgebraSparse;
 }  // namespace eckit::linalg
 
+namespace mir::method::nonlinear {
+class NonLinear;
+}  // namespace mir::method::nonlinear
+
 
 namespace mir::method::solver {
 
@@ -30,6 +37,12 @@ struct Multiply : Solver {
     void solve(const MethodWeighted::Matrix& A, const MethodWeighted::WeightMatrix& W, MethodWeighted::Matrix& B,
                const double& missingValue) const override;
 
+    /// Solve with non-linear treatments applied on the fly on each row, in a single pass over the (unmodified) matrix
+    /// (rows split in ranges solved concurrently)
+    void solve(const MethodWeighted::Matrix& A, const MethodWeighted::WeightMatrix& W, MethodWeighted::Matrix& B,
+               const double& missingValue, const MIRValuesVector& values,
+               const std::vector<std::unique_ptr<const nonlinear::NonLinear>>&, size_t threads = 1) const;
+
 private:
     bool sameAs(const Solver&) const override;
     void print(std::ostream&) const override;
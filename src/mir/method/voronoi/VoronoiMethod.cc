@@ -13,18 +13,19 @@
 #include "mir/method/voronoi/VoronoiMethod.h"
 
 #include <algorithm>
+#include <functional>
 #include <ostream>
-#include <set>
 #include <sstream>
 #include <utility>
 
 #include "eckit/utils/MD5.h"
 
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
 #include "mir/search/PointSearch.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 
 
@@ -43,6 +44,35 @@ struct Biplet : std::pair<size_t, size_t> {
 };
 
 
+/// Append biplets assigned by f(begin, end, biplets) over positions [0, size), in parallel over contiguous ranges
+/// (merged in range order), then sort and remove duplicates
+void assign(size_t size, size_t threads, std::vector<Biplet>& biplets,
+            const std::function<void(size_t, size_t, std::vector<Biplet>&)>& f) {
+    const auto ranges = util::parallel_ranges(size, threads);
+    std::vector<std::vector<Biplet>> assigned(ranges.size());
+
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        auto& local = assigned[r];
+        local.reserve(end - begin);
+        f(begin, end, local);
+    });
+
+    size_t total = biplets.size();
+    for (const auto& local : assigned) {
+        total += local.size();
+    }
+
+    biplets.reserve(total);
+    for (auto& local : assigned) {
+        biplets.insert(biplets.end(), local.begin(), local.end());
+        std::vector<Biplet>().swap(local);
+    }
+
+    std::sort(biplets.begin(), biplets.end());
+    biplets.erase(std::unique(biplets.begin(), biplets.end()), biplets.end());
+}
+
+
 }  // namespace
 
 
@@ -71,31 +101,40 @@ void VoronoiMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
     auto Nin  = in.numberOfPoints();
     auto Nout = out.numberOfPoints();
 
-    std::vector<bool> assigned;
-    assigned.assign(Nout, false);
+    const auto threads = pick_.parallel() ? util::parallel_threads(parametrisation_) : 1;
 
-    std::set<Biplet> biplets;
+    // (output, input) pairs, sorted and unique
+    std::vector<Biplet> biplets;
 
 
     {
-        trace::ProgressTimer progress("assemble: input-based assign", Nin, {"point"});
+        trace::ResourceUsage usage("assemble: input-based assign");
+        log << "assemble: input-based assign " << Log::Pretty(Nin, {"point"}) << " using "
+            << Log::Pretty(threads, {"thread"}) << std::endl;
 
-        std::vector<search::PointSearch::PointValueType> closest;
-        for (const std::unique_ptr<repres::Iterator> it(in.iterator()); it->next();) {
-            if (++progress) {
-                log << *tree << std::endl;
-            }
+        repres::Coordinates coord;
+        in.coordinates(coord);
+        const auto xyz = coord.points3D();
 
-            pick_.pick(*tree, it->point3D(), closest);
-            for (auto& c : closest) {
-                auto i = c.payload();
-                biplets.emplace(i, it->index());
-                assigned[i] = true;
+        assign(coord.size(), threads, biplets, [&](size_t begin, size_t end, std::vector<Biplet>& local) {
+            std::vector<search::PointSearch::PointValueType> closest;
+            for (size_t n = begin; n < end; ++n) {
+                pick_.pick(*tree, xyz[n], closest);
+                for (auto& c : closest) {
+                    local.emplace_back(c.payload(), coord.indices[n]);
+                }
             }
-        }
+        });
     }
 
 
+    // biplets are sorted by output point
+    std::vector<bool> assigned(Nout, false);
+    for (const auto& b : biplets) {
+        ASSERT(b.first < Nout);
+        assigned[b.first] = true;
+    }
+
     auto Nassigned = size_t(std::count(assigned.cbegin(), assigned.cend(), true));
     if (Nassigned < Nout) {
         Log::debug() << "assemble: input-based assignment: " << Nassigned << " of "
@@ -108,25 +147,26 @@ void VoronoiMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
         }
 
         {
-            trace::ProgressTimer progress("assemble: output-based assign", Nout - Nassigned, {"point"});
-
-            std::vector<search::PointSearch::PointValueType> closest;
-            for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
-                auto i = it->index();
-                if (assigned[i]) {
-                    continue;
+            trace::ResourceUsage usage("assemble: output-based assign");
+
+            repres::Coordinates coord;
+            out.coordinates(coord);
+            const auto xyz = coord.points3D();
+
+            assign(coord.size(), threads, biplets, [&](size_t begin, size_t end, std::vector<Biplet>& local) {
+                std::vector<search::PointSearch::PointValueType> closest;
+                for (size_t n = begin; n < end; ++n) {
+                    auto i = coord.indices[n];
+                    if (assigned[i]) {
+                        continue;
+                    }
+
+                    pick_.pick(*tree, xyz[n], closest);
+                    for (auto& c : closest) {
+                        local.emplace_back(i, c.payload());  // duplicates are removed
+                    }
                 }
-
-                if (++progress) {
-                    log << *tree << std::endl;
-                }
-
-                pick_.pick(*tree, it->point3D(), closest);
-                for (auto& c : closest) {
-                    auto j = c.payload();
-                    biplets.emplace(i, j);  // won't insert biplet if existing
-                }
-            }
+            });
         }
     }
 
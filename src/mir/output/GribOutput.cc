@@ -12,10 +12,15 @@
 
 #include "mir/output/GribOutput.h"
 
+#include <algorithm>
+#include <mutex>
 #include <ostream>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "eckit/config/Resource.h"
+#include "eckit/utils/MD5.h"
 
 #include "mir/action/context/Context.h"
 #include "mir/action/io/Copy.h"
@@ -36,7 +41,7 @@
 #include "mir/util/Grib.h"
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
-#include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
 
@@ -44,7 +49,23 @@
 namespace mir::output {
 
 
-static util::recursive_mutex local_mutex;
+/// Protects ecCodes (not recursive, so ScopedUnlock releases it completely)
+static std::mutex local_mutex;
+
+
+/// Releases a (locked) mutex for the scope, for work not involving ecCodes
+class ScopedUnlock {
+    std::mutex& mutex_;
+
+public:
+    explicit ScopedUnlock(std::mutex& mutex) : mutex_(mutex) { mutex_.unlock(); }
+    ~ScopedUnlock() { mutex_.lock(); }
+
+    ScopedUnlock(const ScopedUnlock&)            = delete;
+    ScopedUnlock(ScopedUnlock&&)                 = delete;
+    ScopedUnlock& operator=(const ScopedUnlock&) = delete;
+    ScopedUnlock& operator=(ScopedUnlock&&)      = delete;
+};
 
 
 #define X(a) Log::debug() << "  GRIB encoding: " << #a << " = " << (a) << std::endl
@@ -56,6 +77,132 @@ static util::recursive_mutex local_mutex;
 }
 
 
+/// Output messages to start from (with the geometry and packing encoded), per key; subsequent messages copy the
+/// product definition (and local) sections from input, and set the metadata and values. At most
+/// templates_capacity() entries, least recently used first (evicted first), only accessed with local_mutex held
+static std::vector<std::pair<std::string, std::unique_ptr<grib_handle, decltype(&codes_handle_delete)>>> templates;
+
+
+/// Maximum number of output templates (default 0: disabled)
+static size_t templates_capacity() {
+    static size_t capacity = eckit::Resource<size_t>("$MIR_GRIB_OUTPUT_TEMPLATES", 0);
+    return capacity;
+}
+
+
+/// Key of the output template (geometry, input and output packing, edition and local definition), or empty if not
+/// supported
+static std::string template_key(const param::MIRParametrisation& param, grib_handle* h,
+                                const repres::RepresentationHandle& repres, const grib_info& info) {
+    if (templates_capacity() == 0 || info.grid.grid_type == CODES_UTIL_GRID_SPEC_SH ||
+        info.packing.deleteLocalDefinition != 0 || param.userParametrisation().has("compatibility")) {
+        return "";
+    }
+
+    long edition = 0;
+    GRIB_CALL(codes_get_long(h, "edition", &edition));
+    if (info.packing.editionNumber != 0 && info.packing.editionNumber != edition) {
+        return "";
+    }
+
+    long local = 0;
+    if (codes_get_long(h, "localDefinitionNumber", &local) != CODES_SUCCESS) {
+        local = -1;
+    }
+
+    // Input packing, as packing and accuracy can be kept from input (binaryScaleFactor is recomputed from the values)
+    char packingType[64];
+    size_t len = sizeof(packingType);
+    GRIB_CALL(codes_get_string(h, "packingType", packingType, &len));
+
+    long bitsPerValue       = 0;
+    long decimalScaleFactor = 0;
+    GRIB_CALL(codes_get_long(h, "bitsPerValue", &bitsPerValue));
+    if (codes_get_long(h, "decimalScaleFactor", &decimalScaleFactor) != CODES_SUCCESS) {
+        decimalScaleFactor = 0;
+    }
+
+    const auto& g = info.grid;
+    const auto& p = info.packing;
+
+    eckit::MD5 md5;
+    md5 << repres->uniqueName() << edition << local << std::string(packingType) << bitsPerValue << decimalScaleFactor;
+    md5 << g.grid_type << g.Ni << g.Nj << g.iDirectionIncrementInDegrees << g.jDirectionIncrementInDegrees
+        << g.longitudeOfFirstGridPointInDegrees << g.longitudeOfLastGridPointInDegrees
+        << g.latitudeOfFirstGridPointInDegrees << g.latitudeOfLastGridPointInDegrees << g.uvRelativeToGrid
+        << g.latitudeOfSouthernPoleInDegrees << g.longitudeOfSouthernPoleInDegrees << g.iScansNegatively
+        << g.jScansPositively << g.N << g.pl_size << g.orientationOfTheGridInDegrees << g.DyInMetres
+        << g.DxInMetres;
+    for (long j = 0; j < g.pl_size; j++) {
+        md5 << g.pl[j];
+    }
+    md5 << p.packing_type << p.packing << p.boustrophedonic << p.editionNumber << p.accuracy << p.bitsPerValue
+        << p.decimalScaleFactor;
+
+    return md5.digest();
+}
+
+
+/// Output message from a template, if available (null otherwise)
+static grib_handle* from_template(const std::string& key, grib_handle* h, grib_info& info,
+                                  const data::MIRField& field, size_t i) {
+    if (key.empty()) {
+        return nullptr;
+    }
+
+    auto t = std::find_if(templates.begin(), templates.end(), [&key](const auto& t) { return t.first == key; });
+    if (t == templates.end()) {
+        return nullptr;
+    }
+
+    // most recently used last
+    std::rotate(t, t + 1, templates.end());
+    auto* sample = templates.back().second.get();
+
+    int err = 0;
+    std::unique_ptr<grib_handle, decltype(&codes_handle_delete)> result(
+        codes_grib_util_sections_copy(h, sample, CODES_SECTION_PRODUCT | CODES_SECTION_LOCAL, &err),
+        &codes_handle_delete);
+    GRIB_CALL(err);
+    ASSERT(result);
+
+    long edition = 0;
+    GRIB_CALL(codes_get_long(h, "edition", &edition));
+    if (edition == 2) {
+        long discipline = 0;
+        GRIB_CALL(codes_get_long(h, "discipline", &discipline));
+        GRIB_CALL(codes_set_long(result.get(), "discipline", discipline));
+    }
+
+    if (info.packing.extra_settings_count > 0) {
+        GRIB_CALL(
+            codes_set_values(result.get(), info.packing.extra_settings, size_t(info.packing.extra_settings_count)));
+    }
+
+    GRIB_CALL(codes_set_double(result.get(), "missingValue", field.missingValue()));
+    GRIB_CALL(codes_set_long(result.get(), "bitmapPresent", field.hasMissing()));
+    GRIB_CALL(codes_set_double_array(result.get(), "values", field.values(i).data(), field.values(i).size()));
+
+    return result.release();
+}
+
+
+static void add_template(const std::string& key, grib_handle* result) {
+    if (key.empty()) {
+        return;
+    }
+
+    // evict the least recently used
+    while (templates.size() >= templates_capacity()) {
+        templates.erase(templates.begin());
+    }
+
+    templates.emplace_back(key, std::unique_ptr<grib_handle, decltype(&codes_handle_delete)>(
+                                    codes_handle_clone(result), &codes_handle_delete));
+    ASSERT(templates.back().second);
+}
+
+
 GribOutput::GribOutput() : interpolated_(0), saved_(0) {}
 
 
@@ -72,6 +219,21 @@ size_t GribOutput::saved() const {
 }
 
 
+void GribOutput::write(const void* message, size_t length, bool interpolated) {
+    GRIB_CALL(codes_check_message_header(message, length, PRODUCT_GRIB));
+    GRIB_CALL(codes_check_message_footer(message, length, PRODUCT_GRIB));
+
+    if (interpolated) {
+        interpolated_++;
+    }
+    else {
+        saved_++;
+    }
+
+    out(message, length, interpolated);
+}
+
+
 size_t GribOutput::copy(const param::MIRParametrisation& /*unused*/, context::Context& ctx) {
     saved_++;
 
@@ -216,7 +378,7 @@ size_t GribOutput::save(const param::MIRParametrisation& param, context::Context
     for (size_t i = 0; i < field.dimensions(); i++) {
 
         // Protect ecCodes and set error callback handling (throws)
-        util::lock_guard<util::recursive_mutex> lock(local_mutex);
+        std::lock_guard<std::mutex> lock(local_mutex);
         codes_set_codes_assertion_failed_proc(&eccodes_assertion);
 
         // Special case where only values are changing; handle is cloned, and new values are set
@@ -377,8 +539,23 @@ size_t GribOutput::save(const param::MIRParametrisation& param, context::Context
         int flags          = 0;
         int err            = 0;
 
-        auto* result =
-            codes_grib_util_set_spec(h, &info.grid, &info.packing, flags, values.data(), values.size(), &err);
+        // Start from a template (same geometry and packing) if possible, otherwise from input
+        const auto key  = template_key(param, h, repres, info);
+        auto* result    = from_template(key, h, info, field, i);
+        const bool full = result == nullptr;
+
+        // Values packed by MIR (large fields, in parallel) into a message encoded for a constant field, if supported
+        const long parallelBits = full ? pack->parallelBitsPerValue(h, info, values.size(), field.hasMissing()) : 0;
+
+        if (full) {
+            MIRValuesVector constant;
+            if (parallelBits > 0) {
+                constant.assign(values.size(), 0.);
+            }
+
+            const auto& encode = parallelBits > 0 ? constant : values;
+            result = codes_grib_util_set_spec(h, &info.grid, &info.packing, flags, encode.data(), encode.size(), &err);
+        }
         HandleDeleter hf(result);  // Make sure handle deleted even in case of exception
 
 
@@ -402,10 +579,37 @@ size_t GribOutput::save(const param::MIRParametrisation& param, context::Context
 
         GRIB_CALL(err);
 
+        if (full && parallelBits == 0) {
+            add_template(key, result);
+        }
+
         const void* message;
         size_t size;
         GRIB_CALL(codes_get_message(result, &message, &size));
 
+        std::vector<char> packed;
+        if (parallelBits > 0) {
+            packed.assign(static_cast<const char*>(message), static_cast<const char*>(message) + size);
+
+            bool packedSimple = false;
+            {
+                // MIR packing does not need ecCodes, concurrent encoding can proceed
+                ScopedUnlock unlock(local_mutex);
+                packedSimple = grib::Packing::packSimple(packed, parallelBits, values, util::parallel_threads(param));
+            }
+
+            if (packedSimple) {
+                message = packed.data();
+                size    = packed.size();
+            }
+            else {
+                // message not supported, values packed by ecCodes
+                GRIB_CALL(codes_set_long(result, "bitsPerValue", parallelBits));
+                GRIB_CALL(codes_set_double_array(result, "values", values.data(), values.size()));
+                GRIB_CALL(codes_get_message(result, &message, &size));
+            }
+        }
+
         GRIB_CALL(codes_check_message_header(message, size, PRODUCT_GRIB));
         GRIB_CALL(codes_check_message_footer(message, size, PRODUCT_GRIB));
 
@@ -469,7 +673,7 @@ size_t GribOutput::set(const param::MIRParametrisation& param, context::Context&
     for (size_t i = 0; i < field.dimensions(); i++) {
 
         // Protect ecCodes and set error callback handling (throws)
-        util::lock_guard<util::recursive_mutex> lock(local_mutex);
+        std::lock_guard<std::mutex> lock(local_mutex);
         codes_set_codes_assertion_failed_proc(&eccodes_assertion);
 
         // Make sure handle deleted even in case of exception
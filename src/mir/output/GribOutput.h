@@ -47,6 +47,9 @@ public:
     virtual size_t interpolated() const;
     virtual size_t saved() const;
 
+    /// Output a message encoded elsewhere (for instance, by another GribOutput of the same job)
+    void write(const void* message, size_t length, bool interpolated);
+
     // -- Overridden methods
     // None
 
@@ -0,0 +1,60 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/repres/Coordinates.h"
+
+#include "mir/util/Atlas.h"
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::repres {
+
+
+void Coordinates::clear() {
+    latitudes.clear();
+    longitudes.clear();
+    indices.clear();
+}
+
+
+void Coordinates::reserve(size_t n) {
+    latitudes.reserve(n);
+    longitudes.reserve(n);
+    indices.reserve(n);
+}
+
+
+void Coordinates::resize(size_t n) {
+    latitudes.resize(n);
+    longitudes.resize(n);
+    indices.resize(n);
+}
+
+
+std::vector<Point3> Coordinates::points3D() const {
+    ASSERT(latitudes.size() == size() && longitudes.size() == size());
+
+    std::vector<Point3> points(size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        // notice the order
+        const atlas::PointLonLat pll(longitudes[i], latitudes[i]);
+
+        atlas::PointXYZ pxyz;
+        util::Earth::convertSphericalToCartesian(pll, pxyz);
+        points[i] = pxyz;
+    }
+
+    return points;
+}
+
+
+}  // namespace mir::repres
@@ -0,0 +1,53 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mir/util/Types.h"
+
+
+namespace mir::repres {
+
+
+/**
+ * Point coordinates in bulk (structure of arrays, in iteration order), as filled by Iterator::coordinates
+ */
+struct Coordinates {
+    std::vector<double> latitudes;   ///< [degree]
+    std::vector<double> longitudes;  ///< [degree]
+    std::vector<size_t> indices;     ///< value index of each point
+
+    size_t size() const { return indices.size(); }
+    bool empty() const { return indices.empty(); }
+
+    void clear();
+    void reserve(size_t);
+    void resize(size_t);
+
+    void emplace_back(double lat, double lon, size_t index) {
+        latitudes.emplace_back(lat);
+        longitudes.emplace_back(lon);
+        indices.emplace_back(index);
+    }
+
+    Point2 point(size_t i) const { return {latitudes[i], longitudes[i]}; }
+    PointLatLon pointLatLon(size_t i) const { return {latitudes[i], longitudes[i]}; }
+
+    /// Earth-centred Cartesian coordinates (see Iterator::point3D)
+    std::vector<Point3> points3D() const;
+};
+
+
+}  // namespace mir::repres
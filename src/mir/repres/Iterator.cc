@@ -14,6 +14,7 @@
 
 #include <ostream>
 
+#include "mir/repres/Coordinates.h"
 #include "mir/util/Atlas.h"
 #include "mir/util/Exceptions.h"
 
@@ -61,6 +62,35 @@ Iterator& Iterator::next() {
 }
 
 
+void Iterator::coordinates(Coordinates& coord, bool rotated) {
+    ASSERT(valid_);
+
+    coord.clear();
+    unrotatedCoordinates(coord);
+    valid_ = false;
+
+    ASSERT(coord.latitudes.size() == coord.size() && coord.longitudes.size() == coord.size());
+
+    if (rotated && rotation_.rotated()) {
+        for (size_t i = 0; i < coord.size(); ++i) {
+            atlas::PointLonLat p(coord.longitudes[i], coord.latitudes[i]);
+            rotation_.rotate(p.data());
+
+            // notice the order
+            coord.latitudes[i]  = p.lat();
+            coord.longitudes[i] = p.lon();
+        }
+    }
+}
+
+
+void Iterator::unrotatedCoordinates(Coordinates& coord) {
+    while (next(lat_, lon_)) {
+        coord.emplace_back(lat_.value(), lon_.value(), index());
+    }
+}
+
+
 Point3 Iterator::point3D() const {
     ASSERT(valid_);
 
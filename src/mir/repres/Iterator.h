@@ -22,6 +22,9 @@ namespace mir {
 namespace repres {
 
 
+struct Coordinates;
+
+
 class Iterator : protected PointLatLon {
 public:
     // -- Exceptions
@@ -55,6 +58,10 @@ public:
     Iterator& next();
     virtual size_t index() const = 0;
 
+    /// Fill coordinates (rotated, as pointRotated, or not, as pointUnrotated) and indices of all points in bulk,
+    /// exhausting the iterator (which should not have been advanced)
+    void coordinates(Coordinates&, bool rotated = true);
+
     // -- Overridden methods
     // None
 
@@ -76,6 +83,9 @@ protected:
     void print(std::ostream&) const override = 0;
     virtual bool next(Latitude&, Longitude&) = 0;
 
+    /// Fill unrotated coordinates of all points in bulk (default: point by point)
+    virtual void unrotatedCoordinates(Coordinates&);
+
     // -- Overridden methods
     // None
 
@@ -266,6 +266,12 @@ Iterator* Representation::iterator() const {
 }
 
 
+void Representation::coordinates(Coordinates& coord, bool rotated) const {
+    std::unique_ptr<Iterator> it(iterator());
+    it->coordinates(coord, rotated);
+}
+
+
 const Representation* Representation::globalise(data::MIRField& field) const {
     const util::Domain dom = domain();
 
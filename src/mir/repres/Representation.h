@@ -36,6 +36,7 @@ class MIRParametrisation;
 
 namespace repres {
 class Iterator;
+struct Coordinates;
 }
 
 namespace util {
@@ -85,6 +86,9 @@ public:
 
     virtual Iterator* iterator() const;
 
+    /// Point coordinates and value indices, in iteration order and in bulk (see Iterator::coordinates)
+    void coordinates(Coordinates&, bool rotated = true) const;
+
     virtual void validate(const MIRValuesVector&) const;
 
     virtual void fillGrib(grib_info&) const;
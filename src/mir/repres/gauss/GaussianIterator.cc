@@ -14,6 +14,7 @@
 
 #include <ostream>
 
+#include "mir/repres/Coordinates.h"
 #include "mir/util/Exceptions.h"
 
 
@@ -109,6 +110,39 @@ bool GaussianIterator::next(Latitude& lat, Longitude& lon) {
 }
 
 
+void GaussianIterator::unrotatedCoordinates(Coordinates& coord) {
+    ASSERT(first_ && i_ == 0 && j_ == 0 && Ni_ == 0);
+
+    const auto globe = Longitude::GLOBE.value();
+
+    for (; j_ < Nj_; ++j_) {
+        const auto Ni = resetToRow(k_ + j_);
+        if (Ni == 0) {
+            continue;
+        }
+
+        // longitudes (Nw + i) * 360 / pl are exact rationals, so their (correctly rounded) division matches the
+        // conversion of eckit::Fraction, point by point
+        const auto Nw  = double((lon_ / inc_).integralPart());
+        const auto pl  = double(pl_[k_ + j_]);
+        const auto lat = lat_.value();
+
+        const auto n = coord.size();
+        coord.resize(n + Ni);
+
+        auto* lats    = coord.latitudes.data() + n;
+        auto* lons    = coord.longitudes.data() + n;
+        auto* indices = coord.indices.data() + n;
+
+        for (size_t i = 0; i < Ni; ++i) {
+            lats[i]    = lat;
+            lons[i]    = (Nw + double(i)) * globe / pl;
+            indices[i] = n + i;
+        }
+    }
+}
+
+
 size_t GaussianIterator::index() const {
     return count_;
 }
@@ -48,6 +48,7 @@ private:
 protected:
     void print(std::ostream&) const override;
     bool next(Latitude&, Longitude&) override;
+    void unrotatedCoordinates(Coordinates&) override;
     size_t index() const override;
     size_t resetToRow(size_t j);
 };
@@ -15,6 +15,7 @@
 #include <memory>
 #include <ostream>
 #include <sstream>
+#include <vector>
 
 #include "eckit/types/FloatCompare.h"
 #include "eckit/types/Fraction.h"
@@ -22,6 +23,7 @@
 #include "mir/data/MIRField.h"
 #include "mir/iterator/detail/RegularIterator.h"
 #include "mir/param/MIRParametrisation.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Grib.h"
@@ -336,6 +338,41 @@ bool LatLon::LatLonIterator::next(Latitude& lat, Longitude& lon) {
 }
 
 
+void LatLon::LatLonIterator::unrotatedCoordinates(Coordinates& coord) {
+    ASSERT(first_ && i_ == 0 && j_ == 0);
+
+    if (ni_ == 0 || nj_ == 0) {
+        return;
+    }
+
+    // exact (eckit::Fraction) latitudes and longitudes, per row and column
+    std::vector<double> lats(nj_);
+    for (auto& lat : lats) {
+        lat = Latitude(lat_).value();
+        lat_ -= ns_;
+    }
+
+    std::vector<double> lons(ni_);
+    for (auto& lon : lons) {
+        lon = Longitude(lon_).value();
+        lon_ += we_;
+    }
+
+    coord.resize(ni_ * nj_);
+    for (size_t j = 0, n = 0; j < nj_; ++j) {
+        for (size_t i = 0; i < ni_; ++i, ++n) {
+            coord.latitudes[n]  = lats[j];
+            coord.longitudes[n] = lons[i];
+            coord.indices[n]    = n;
+        }
+    }
+
+    // exhausted
+    j_     = nj_;
+    count_ = ni_ * nj_ - 1;
+}
+
+
 void LatLon::globaliseBoundingBox(util::BoundingBox& bbox, const util::Increments& inc, const PointLatLon& reference) {
     using eckit::Fraction;
     using iterator::detail::RegularIterator;
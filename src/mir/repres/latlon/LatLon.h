@@ -115,6 +115,7 @@ protected:
         ~LatLonIterator();
         void print(std::ostream&) const;
         bool next(Latitude&, Longitude&);
+        void unrotatedCoordinates(Coordinates&);
 
     public:
         LatLonIterator(size_t ni, size_t nj, Latitude north, Longitude west, const util::Increments& increments);
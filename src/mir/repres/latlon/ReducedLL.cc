@@ -23,6 +23,7 @@
 
 #include "mir/api/MIRJob.h"
 #include "mir/param/MIRParametrisation.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Iterator.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
@@ -240,6 +241,34 @@ class ReducedLLIterator : public Iterator {
         return false;
     }
 
+    void unrotatedCoordinates(Coordinates& coord) override {
+        ASSERT(first_ && i_ == 0 && j_ == 0);
+
+        // same (eckit::Fraction) arithmetic as next(), without per-point dispatch
+        for (; j_ < nj_; ++j_) {
+            const Latitude lat(latitude_);
+            for (i_ = 0; i_ < ni_; ++i_) {
+                const Longitude lon(longitude_);
+                if (domain_.contains(lat, lon)) {
+                    coord.emplace_back(lat.value(), lon.value(), coord.size());
+                }
+                longitude_ += inc_west_east_;
+            }
+
+            latitude_ -= inc_north_south_;
+            longitude_ = west_;
+
+            if (j_ + 1 < nj_) {
+                ASSERT(p_ < pl_.size());
+                ni_ = size_t(pl_[p_++]);
+                ASSERT(ni_ > 1);
+                inc_west_east_ = ew_ / (ni_ - (periodic_ ? 0 : 1));
+            }
+        }
+
+        i_ = 0;
+    }
+
     size_t index() const override { return count_; }
 
 public:
@@ -42,6 +42,7 @@ Iterator* RegularLL::iterator() const {
             out << "]";
         }
         bool next(Latitude& lat, Longitude& lon) override { return LatLonIterator::next(lat, lon); }
+        void unrotatedCoordinates(Coordinates& coord) override { LatLonIterator::unrotatedCoordinates(coord); }
 
         size_t index() const override { return count_; }
 
@@ -23,6 +23,7 @@
 #include "eckit/utils/StringTools.h"
 
 #include "mir/param/MIRParametrisation.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Iterator.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
@@ -284,6 +285,22 @@ Iterator* RegularGrid::iterator() const {
             return false;
         }
 
+        void unrotatedCoordinates(Coordinates& coord) override {
+            ASSERT(i_ == 0 && j_ == 0);
+
+            coord.resize(ni_ * nj_);
+            for (size_t n = 0; j_ < nj_; ++j_) {
+                const auto y = y_[j_];
+                for (i_ = 0; i_ < ni_; ++i_, ++n) {
+                    pLonLat_ = projection_.lonlat({x_[i_], y});
+
+                    coord.latitudes[n]  = pLonLat_.lat();
+                    coord.longitudes[n] = pLonLat_.lon();
+                    coord.indices[n]    = n;
+                }
+            }
+        }
+
         size_t index() const override { return count_; }
 
     public:
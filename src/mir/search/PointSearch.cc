@@ -12,14 +12,18 @@
 
 #include "mir/search/PointSearch.h"
 
+#include <utility>
+
 #include "eckit/config/Resource.h"
 #include "eckit/thread/AutoLock.h"
 
 #include "mir/config/LibMir.h"
 #include "mir/param/MIRParametrisation.h"
-#include "mir/repres/Iterator.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
+#include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
 
@@ -37,16 +41,53 @@ static std::string extract_loader(const param::MIRParametrisation& param) {
 }
 
 
-PointSearch::PointSearch(const param::MIRParametrisation& param, const repres::Representation& r) {
+static void closest_n_points(const Tree& tree, const Tree::Point& pt, size_t n,
+                             std::vector<Tree::PointValueType>& closest) {
+    // Small optimisation
+    if (n == 1) {
+        closest.clear();
+        closest.emplace_back(tree.nearestNeighbour(pt));
+        return;
+    }
+
+    tree.kNearestNeighbours(pt, n, closest);
+}
+
+
+PointSearch::PointSearch(const param::MIRParametrisation& param, const repres::Representation& r) :
+    concurrent_(false) {
     tree_.reset(TreeFactory::build(extract_loader(param), r));
-    eckit::AutoLock<Tree> lock(*tree_);
+    {
+        eckit::AutoLock<Tree> lock(*tree_);
 
-    Log::debug() << "Search using " << *tree_ << std::endl;
+        Log::debug() << "Search using " << *tree_ << std::endl;
 
-    if (!tree_->ready()) {
-        build(r);
-        tree_->commit();
+        if (!tree_->ready()) {
+            build(r);
+            tree_->commit();
+        }
     }
+
+    // batched queries run concurrently on reentrant trees, or on independent (read-only) views of the tree
+    concurrent_ = tree_->reentrant() || std::unique_ptr<Tree>(tree_->view());
+}
+
+
+template <typename F>
+void PointSearch::query(size_t size, size_t threads, F&& f) const {
+    const auto ranges = util::parallel_ranges(size, concurrent_ ? threads : 1);
+    const auto views  = ranges.size() > 1 && !tree_->reentrant();
+
+    // the first range queries the tree, others (if not reentrant) a view each
+    util::parallel_for(ranges, [&](size_t r, size_t begin, size_t end) {
+        std::unique_ptr<Tree> view;
+        if (views && r > 0) {
+            view.reset(tree_->view());
+            ASSERT(view);
+        }
+
+        f(view ? *view : *tree_, begin, end);
+    });
 }
 
 
@@ -56,20 +97,36 @@ PointSearch::PointValueType PointSearch::closestPoint(const PointSearch::PointTy
 
 
 void PointSearch::closestNPoints(const PointType& pt, size_t n, std::vector<PointValueType>& closest) const {
+    closest_n_points(*tree_, pt, n, closest);
+}
 
-    // Small optimisation
-    if (n == 1) {
-        closest.clear();
-        closest.push_back(closestPoint(pt));
-        return;
-    }
 
-    closest = tree_->kNearestNeighbours(pt, n);
+void PointSearch::closestWithinRadius(const PointType& pt, double radius, std::vector<PointValueType>& closest) const {
+    tree_->findInSphere(pt, radius, closest);
 }
 
 
-void PointSearch::closestWithinRadius(const PointType& pt, double radius, std::vector<PointValueType>& closest) const {
-    closest = tree_->findInSphere(pt, radius);
+void PointSearch::closestNPoints(const std::vector<PointType>& pts, size_t n,
+                                 std::vector<std::vector<PointValueType>>& closest, size_t threads) const {
+    closest.resize(pts.size());
+
+    query(pts.size(), threads, [&](const Tree& tree, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            closest_n_points(tree, pts[i], n, closest[i]);
+        }
+    });
+}
+
+
+void PointSearch::closestWithinRadius(const std::vector<PointType>& pts, double radius,
+                                      std::vector<std::vector<PointValueType>>& closest, size_t threads) const {
+    closest.resize(pts.size());
+
+    query(pts.size(), threads, [&](const Tree& tree, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            tree.findInSphere(pts[i], radius, closest[i]);
+        }
+    });
 }
 
 
@@ -84,12 +141,16 @@ void PointSearch::build(const repres::Representation& r) {
     static bool fastBuildKDTrees =
         eckit::Resource<bool>("$ATLAS_FAST_BUILD_KDTREES", true);  // We use the same Resource as ATLAS for now
 
+    repres::Coordinates coord;
+    r.coordinates(coord);
+    const auto xyz = coord.points3D();
+
     if (fastBuildKDTrees) {
         std::vector<PointValueType> points;
-        points.reserve(npts);
+        points.reserve(xyz.size());
 
-        for (const std::unique_ptr<repres::Iterator> it(r.iterator()); it->next();) {
-            points.emplace_back(PointValueType(it->point3D(), it->index()));
+        for (size_t i = 0; i < xyz.size(); ++i) {
+            points.emplace_back(PointValueType(xyz[i], coord.indices[i]));
         }
 
         tree_->build(points);
@@ -99,8 +160,8 @@ void PointSearch::build(const repres::Representation& r) {
         }
     }
     else {
-        for (const std::unique_ptr<repres::Iterator> it(r.iterator()); it->next();) {
-            tree_->insert(PointValueType(it->point3D(), it->index()));
+        for (size_t i = 0; i < xyz.size(); ++i) {
+            tree_->insert(PointValueType(xyz[i], coord.indices[i]));
         }
     }
 }
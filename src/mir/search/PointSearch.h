@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mir/search/Tree.h"
 
@@ -64,6 +65,18 @@ public:
     /// Finds closest points within a radius
     void closestWithinRadius(const PointType&, double radius, std::vector<PointValueType>& closest) const;
 
+    /// Finds closest N points to each input point (concurrently, if threads > 1 and supported by the tree)
+    void closestNPoints(const std::vector<PointType>&, size_t n, std::vector<std::vector<PointValueType>>& closest,
+                        size_t threads = 1) const;
+
+    /// Finds closest points within a radius of each input point (concurrently, if threads > 1 and supported by the
+    /// tree)
+    void closestWithinRadius(const std::vector<PointType>&, double radius,
+                             std::vector<std::vector<PointValueType>>& closest, size_t threads = 1) const;
+
+    /// If batched queries run concurrently (otherwise, they are serialised)
+    bool concurrent() const { return concurrent_; }
+
     // -- Overridden methods
     // None
 
@@ -93,11 +106,16 @@ private:
     // -- Members
 
     std::unique_ptr<Tree> tree_;
+    bool concurrent_;
 
     // -- Methods
 
     void build(const repres::Representation&);
 
+    /// Query ranges of [0, size) concurrently, as f(tree, begin, end)
+    template <typename F>
+    void query(size_t size, size_t threads, F&&) const;
+
     void print(std::ostream&) const;
 
     // -- Overridden methods
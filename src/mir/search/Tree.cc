@@ -28,7 +28,10 @@ namespace mir::search {
 Tree::~Tree() = default;
 
 
-Tree::Tree(const repres::Representation& r) : itemCount_(r.numberOfPoints()) {
+Tree::Tree(const repres::Representation& r) : Tree(r.numberOfPoints()) {}
+
+
+Tree::Tree(size_t itemCount) : itemCount_(itemCount) {
     ASSERT(itemCount_ > 0);
 }
 
@@ -61,27 +64,38 @@ void Tree::statsReset() {
 }
 
 
-Tree::PointValueType Tree::nearestNeighbour(const Point& /*unused*/) {
+Tree::PointValueType Tree::nearestNeighbour(const Point& /*unused*/) const {
     std::ostringstream os;
     os << "Tree::nearestNeighbour() not implemented for " << *this;
     throw exception::SeriousBug(os.str());
 }
 
 
-std::vector<Tree::PointValueType> Tree::kNearestNeighbours(const Point& /*unused*/, size_t /*unused*/) {
+void Tree::kNearestNeighbours(const Point& /*unused*/, size_t /*unused*/,
+                              std::vector<PointValueType>& /*unused*/) const {
     std::ostringstream os;
     os << "Tree::kNearestNeighbours() not implemented for " << *this;
     throw exception::SeriousBug(os.str());
 }
 
 
-std::vector<Tree::PointValueType> Tree::findInSphere(const Point& /*unused*/, double /*unused*/) {
+void Tree::findInSphere(const Point& /*unused*/, double /*unused*/, std::vector<PointValueType>& /*unused*/) const {
     std::ostringstream os;
     os << "Tree::findInSphere() not implemented for " << *this;
     throw exception::SeriousBug(os.str());
 }
 
 
+bool Tree::reentrant() const {
+    return false;
+}
+
+
+Tree* Tree::view() const {
+    return nullptr;
+}
+
+
 bool Tree::ready() const {
     std::ostringstream os;
     os << "Tree::ready() not implemented for " << *this;
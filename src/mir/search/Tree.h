@@ -48,9 +48,16 @@ public:
     virtual void statsPrint(std::ostream&, bool);
     virtual void statsReset();
 
-    virtual PointValueType nearestNeighbour(const Point&);
-    virtual std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k);
-    virtual std::vector<PointValueType> findInSphere(const Point&, double);
+    virtual PointValueType nearestNeighbour(const Point&) const;
+    virtual void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&) const;
+    virtual void findInSphere(const Point&, double, std::vector<PointValueType>&) const;
+
+    /// If queries can run concurrently on this tree (otherwise, the tree serialises them)
+    virtual bool reentrant() const;
+
+    /// Independent (read-only) tree sharing this tree's storage, for concurrent queries on a tree that is not
+    /// reentrant (nullptr if not supported)
+    virtual Tree* view() const;
 
     virtual bool ready() const;
     virtual void commit();
@@ -66,6 +73,9 @@ public:
         return s;
     }
 
+protected:
+    explicit Tree(size_t itemCount);
+
 private:
     const size_t itemCount_;
 };
@@ -12,10 +12,36 @@
 
 #include "mir/search/tree/TreeMapped.h"
 
+#include <ostream>
+
+#include "mir/util/Exceptions.h"
+
 
 namespace mir::search::tree {
 
 
+namespace {
+
+
+class TreeMappedView final : public TreeMapped {
+    bool ready() const override { return true; }
+
+    void commit() override { throw exception::SeriousBug("TreeMappedView: read-only"); }
+
+    void print(std::ostream& out) const override {
+        out << "TreeMappedView["
+               "path="
+            << path_ << "]";
+    }
+
+public:
+    TreeMappedView(size_t itemCount, const eckit::PathName& path) : TreeMapped(itemCount, path) {}
+};
+
+
+}  // namespace
+
+
 void TreeMapped::build(std::vector<Tree::PointValueType>& v) {
     tree_.build(v);
 }
@@ -27,36 +53,44 @@ void TreeMapped::insert(const Tree::PointValueType& pt) {
 
 
 void TreeMapped::statsPrint(std::ostream& out, bool pretty) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
     tree_.statsPrint(out, pretty);
 }
 
 
 void TreeMapped::statsReset() {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
     tree_.statsReset();
 }
 
 
-Tree::PointValueType TreeMapped::nearestNeighbour(const Tree::Point& pt) {
+Tree::PointValueType TreeMapped::nearestNeighbour(const Tree::Point& pt) const {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
     const auto& nn = tree_.nearestNeighbour(pt).value();
     return {nn.point(), nn.payload()};
 }
 
 
-std::vector<Tree::PointValueType> TreeMapped::kNearestNeighbours(const Tree::Point& pt, size_t k) {
-    std::vector<PointValueType> result;
+void TreeMapped::kNearestNeighbours(const Tree::Point& pt, size_t k, std::vector<PointValueType>& result) const {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+    result.clear();
     for (const auto& n : tree_.kNearestNeighbours(pt, k)) {
-        result.emplace_back(PointValueType(n.point(), n.payload()));
+        result.emplace_back(n.point(), n.payload());
     }
-    return result;
 }
 
 
-std::vector<Tree::PointValueType> TreeMapped::findInSphere(const Tree::Point& pt, double radius) {
-    std::vector<PointValueType> result;
+void TreeMapped::findInSphere(const Tree::Point& pt, double radius, std::vector<PointValueType>& result) const {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+    result.clear();
     for (const auto& n : tree_.findInSphere(pt, radius)) {
-        result.emplace_back(PointValueType(n.point(), n.payload()));
+        result.emplace_back(n.point(), n.payload());
     }
-    return result;
+}
+
+
+Tree* TreeMapped::mappedView(const eckit::PathName& path) const {
+    return path.exists() ? new TreeMappedView(itemCount(), path) : nullptr;
 }
 
 
@@ -64,4 +98,8 @@ TreeMapped::TreeMapped(const repres::Representation& r, const eckit::PathName& p
     Tree(r), umask_(0), path_(path), tree_(path, path.exists() ? 0 : itemCount(), 0) {}
 
 
+TreeMapped::TreeMapped(size_t itemCount, const eckit::PathName& path) :
+    Tree(itemCount), umask_(0), path_(path), tree_(path, path.exists() ? 0 : itemCount, 0) {}
+
+
 }  // namespace mir::search::tree
@@ -16,6 +16,7 @@
 #include "eckit/os/AutoUmask.h"
 
 #include "mir/search/Tree.h"
+#include "mir/util/Mutex.h"
 
 
 namespace mir::search::tree {
@@ -26,7 +27,8 @@ class TreeMapped : public Tree {
 protected:
     eckit::AutoUmask umask_;  // Must be first
     eckit::PathName path_;
-    eckit::KDTreeMapped<Tree> tree_;
+    mutable eckit::KDTreeMapped<Tree> tree_;  // queries update the tree statistics, so they are serialised
+    mutable util::recursive_mutex mutex_;
 
     void build(std::vector<PointValueType>&) override;
 
@@ -36,11 +38,11 @@ protected:
 
     void statsReset() override;
 
-    PointValueType nearestNeighbour(const Tree::Point&) override;
+    PointValueType nearestNeighbour(const Tree::Point&) const override;
 
-    std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k) override;
+    void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&) const override;
 
-    std::vector<PointValueType> findInSphere(const Point&, double radius) override;
+    void findInSphere(const Point&, double radius, std::vector<PointValueType>&) const override;
 
     bool ready() const override = 0;
 
@@ -48,6 +50,11 @@ protected:
 
     void print(std::ostream&) const override = 0;
 
+    /// Read-only view of an existing (complete) tree file
+    Tree* mappedView(const eckit::PathName&) const;
+
+    TreeMapped(size_t itemCount, const eckit::PathName&);
+
 public:
     TreeMapped(const repres::Representation&, const eckit::PathName&);
 };
@@ -16,7 +16,7 @@
 namespace mir::search::tree {
 
 
-TreeMappedAnonymousMemory::TreeMappedAnonymousMemory(const repres::Representation& r) : TreeMapped(r, "/dev/zero") {}
+TreeMappedAnonymousMemory::TreeMappedAnonymousMemory(const repres::Representation& r) : TreeMemory(r) {}
 
 
 static const TreeBuilder<TreeMappedAnonymousMemory> builder("mapped-anonymous-memory");
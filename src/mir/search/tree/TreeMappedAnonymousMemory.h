@@ -12,17 +12,14 @@
 
 #pragma once
 
-#include "mir/search/tree/TreeMapped.h"
+#include "mir/search/tree/TreeMemory.h"
 
 
 namespace mir::search::tree {
 
 
-class TreeMappedAnonymousMemory : public TreeMapped {
-
-    bool ready() const override { return false; }
-
-    void commit() override {}
+/// In-memory k-d tree, as TreeMemory (formerly a k-d tree mapped from /dev/zero, of non-reentrant queries)
+class TreeMappedAnonymousMemory : public TreeMemory {
 
     void print(std::ostream& out) const override { out << "TreeMappedAnonymousMemory[]"; }
 
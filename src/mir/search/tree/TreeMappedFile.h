@@ -37,6 +37,9 @@ protected:
 
     void commit() override { eckit::PathName::rename(path_, real_); }
 
+    // the committed file can be mapped again, independently
+    Tree* view() const override { return mappedView(real_); }
+
     void print(std::ostream& out) const override {
         out << "TreeMappedFile["
                "path="
@@ -12,51 +12,225 @@
 
 #include "mir/search/tree/TreeMemory.h"
 
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <utility>
+
+#include "mir/util/Exceptions.h"
+
 
 namespace mir::search::tree {
 
 
+namespace {
+
+
+// order of results: by distance, then by payload (deterministic on ties)
+struct Closer {
+    const Tree::Point& pt;
+    bool operator()(const Tree::PointValueType& a, const Tree::PointValueType& b) const {
+        const auto da = Tree::Point::distance2(pt, a.point());
+        const auto db = Tree::Point::distance2(pt, b.point());
+        return da < db || (!(db < da) && a.payload() < b.payload());
+    }
+};
+
+
+}  // namespace
+
+
 void TreeMemory::build(std::vector<Tree::PointValueType>& v) {
-    tree_.build(v);
+    nodes_.assign(v.begin(), v.end());
+    axes_.clear();
+    commit();
 }
 
 
 void TreeMemory::insert(const Tree::PointValueType& pt) {
-    tree_.insert(pt);
+    nodes_.emplace_back(pt);
+    axes_.clear();
 }
 
 
 void TreeMemory::statsPrint(std::ostream& out, bool pretty) {
-    tree_.statsPrint(out, pretty);
+    out << "TreeMemory[queries=" << queries_.load() << ",visits=" << visits_.load() << "]";
+    if (pretty) {
+        out << std::endl;
+    }
 }
 
 
 void TreeMemory::statsReset() {
-    tree_.statsReset();
+    queries_ = 0;
+    visits_  = 0;
 }
 
 
-Tree::PointValueType TreeMemory::nearestNeighbour(const Tree::Point& pt) {
-    const auto& nn = tree_.nearestNeighbour(pt).value();
-    return {nn.point(), nn.payload()};
+void TreeMemory::split(size_t begin, size_t end) {
+    if (end - begin < 2) {
+        return;
+    }
+
+    double min[3];
+    double max[3];
+    for (size_t d = 0; d < 3; ++d) {
+        min[d] = max[d] = nodes_[begin].point()[d];
+    }
+
+    for (auto i = begin + 1; i < end; ++i) {
+        const auto& p = nodes_[i].point();
+        for (size_t d = 0; d < 3; ++d) {
+            min[d] = std::min(min[d], p[d]);
+            max[d] = std::max(max[d], p[d]);
+        }
+    }
+
+    unsigned char axis = 0;
+    for (unsigned char d = 1; d < 3; ++d) {
+        if (max[d] - min[d] > max[axis] - min[axis]) {
+            axis = d;
+        }
+    }
+
+    const auto mid = begin + (end - begin) / 2;
+    std::nth_element(nodes_.begin() + begin, nodes_.begin() + mid, nodes_.begin() + end,
+                     [axis](const PointValueType& a, const PointValueType& b) {
+                         return a.point()[axis] < b.point()[axis];
+                     });
+    axes_[mid] = axis;
+
+    split(begin, mid);
+    split(mid + 1, end);
 }
 
 
-std::vector<Tree::PointValueType> TreeMemory::kNearestNeighbours(const Tree::Point& pt, size_t k) {
-    std::vector<PointValueType> result;
-    for (const auto& n : tree_.kNearestNeighbours(pt, k)) {
-        result.emplace_back(PointValueType(n.point(), n.payload()));
+template <typename Visitor>
+void TreeMemory::search(const Point& pt, size_t begin, size_t end, Visitor& visitor) const {
+    if (begin >= end) {
+        return;
     }
-    return result;
+
+    const auto mid   = begin + (end - begin) / 2;
+    const auto& node = nodes_[mid];
+    visitor.visit(node);
+
+    if (end - begin > 1) {
+        const auto axis = axes_[mid];
+        const auto diff = pt[axis] - node.point()[axis];
+
+        // nearer side first, the farther side only if within bound (squared distance)
+        const auto nearer  = diff < 0 ? std::make_pair(begin, mid) : std::make_pair(mid + 1, end);
+        const auto farther = diff < 0 ? std::make_pair(mid + 1, end) : std::make_pair(begin, mid);
+
+        search(pt, nearer.first, nearer.second, visitor);
+        if (diff * diff <= visitor.bound()) {
+            search(pt, farther.first, farther.second, visitor);
+        }
+    }
+}
+
+
+Tree::PointValueType TreeMemory::nearestNeighbour(const Tree::Point& pt) const {
+    ASSERT(!nodes_.empty());
+    ASSERT(axes_.size() == nodes_.size());
+
+    struct Nearest {
+        const Point& pt;
+        const PointValueType* best;
+        double distance2;
+        size_t visits;
+
+        void visit(const PointValueType& node) {
+            ++visits;
+            const auto d2 = Point::distance2(pt, node.point());
+            if (d2 < distance2 || (!(distance2 < d2) && node.payload() < best->payload())) {
+                best      = &node;
+                distance2 = d2;
+            }
+        }
+
+        double bound() const { return distance2; }
+    } nearest{pt, &nodes_.front(), std::numeric_limits<double>::infinity(), 0};
+
+    search(pt, 0, nodes_.size(), nearest);
+
+    queries_.fetch_add(1, std::memory_order_relaxed);
+    visits_.fetch_add(nearest.visits, std::memory_order_relaxed);
+    return *nearest.best;
 }
 
 
-std::vector<Tree::PointValueType> TreeMemory::findInSphere(const Tree::Point& pt, double radius) {
-    std::vector<PointValueType> result;
-    for (const auto& n : tree_.findInSphere(pt, radius)) {
-        result.emplace_back(PointValueType(n.point(), n.payload()));
+void TreeMemory::kNearestNeighbours(const Tree::Point& pt, size_t k, std::vector<PointValueType>& result) const {
+    ASSERT(axes_.size() == nodes_.size());
+
+    // result is a max-heap of the k closest
+    struct KNearest {
+        const Closer closer;
+        const size_t k;
+        std::vector<PointValueType>& result;
+        size_t visits;
+
+        void visit(const PointValueType& node) {
+            ++visits;
+            if (result.size() < k) {
+                result.emplace_back(node);
+                std::push_heap(result.begin(), result.end(), closer);
+            }
+            else if (closer(node, result.front())) {
+                std::pop_heap(result.begin(), result.end(), closer);
+                result.back() = node;
+                std::push_heap(result.begin(), result.end(), closer);
+            }
+        }
+
+        double bound() const {
+            return result.size() < k ? std::numeric_limits<double>::infinity()
+                                     : Point::distance2(closer.pt, result.front().point());
+        }
+    } nearest{Closer{pt}, k, result, 0};
+
+    result.clear();
+    if (k > 0) {
+        search(pt, 0, nodes_.size(), nearest);
+        std::sort_heap(result.begin(), result.end(), nearest.closer);
     }
-    return result;
+
+    queries_.fetch_add(1, std::memory_order_relaxed);
+    visits_.fetch_add(nearest.visits, std::memory_order_relaxed);
+}
+
+
+void TreeMemory::findInSphere(const Tree::Point& pt, double radius, std::vector<PointValueType>& result) const {
+    ASSERT(axes_.size() == nodes_.size());
+
+    struct InSphere {
+        const Point& pt;
+        const double radius2;
+        std::vector<PointValueType>& result;
+        size_t visits;
+
+        void visit(const PointValueType& node) {
+            ++visits;
+            if (Point::distance2(pt, node.point()) <= radius2) {
+                result.emplace_back(node);
+            }
+        }
+
+        double bound() const { return radius2; }
+    } inSphere{pt, radius * radius, result, 0};
+
+    result.clear();
+    search(pt, 0, nodes_.size(), inSphere);
+    std::sort(result.begin(), result.end(), Closer{pt});
+
+    queries_.fetch_add(1, std::memory_order_relaxed);
+    visits_.fetch_add(inSphere.visits, std::memory_order_relaxed);
+}
+
+
+bool TreeMemory::reentrant() const {
+    return true;
 }
 
 
@@ -65,7 +239,12 @@ bool TreeMemory::ready() const {
 }
 
 
-void TreeMemory::commit() {}
+void TreeMemory::commit() {
+    if (axes_.size() != nodes_.size()) {
+        axes_.assign(nodes_.size(), 0);
+        split(0, nodes_.size());
+    }
+}
 
 
 void TreeMemory::print(std::ostream& out) const {
@@ -12,7 +12,7 @@
 
 #pragma once
 
-#include "eckit/container/KDTree.h"
+#include <atomic>
 
 #include "mir/search/Tree.h"
 
@@ -20,11 +20,14 @@
 namespace mir::search::tree {
 
 
+/**
+ * In-memory k-d tree, stored implicitly (balanced, the node of each range [begin, end) is at its middle, splitting on
+ * the axis of largest extent). Queries are reentrant (read-only, with atomic statistics) and write into the result
+ * vector only, which they use as scratch buffer.
+ */
 class TreeMemory : public Tree {
 
 protected:
-    eckit::KDTreeMemory<Tree> tree_;
-
     void build(std::vector<PointValueType>&) override;
 
     void insert(const PointValueType&) override;
@@ -33,11 +36,13 @@ protected:
 
     void statsReset() override;
 
-    PointValueType nearestNeighbour(const Tree::Point&) override;
+    PointValueType nearestNeighbour(const Tree::Point&) const override;
 
-    std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k) override;
+    void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&) const override;
 
-    std::vector<PointValueType> findInSphere(const Point&, double radius) override;
+    void findInSphere(const Point&, double radius, std::vector<PointValueType>&) const override;
+
+    bool reentrant() const override;
 
     bool ready() const override;
 
@@ -47,6 +52,21 @@ protected:
 
 public:
     using Tree::Tree;
+
+    /// Tree of any points (not of a representation's), such as element centres
+    explicit TreeMemory(size_t itemCount) : Tree(itemCount) {}
+
+private:
+    std::vector<PointValueType> nodes_;
+    std::vector<unsigned char> axes_;  ///< split axis of each node (empty if not split yet)
+
+    mutable std::atomic<size_t> queries_{0};
+    mutable std::atomic<size_t> visits_{0};
+
+    void split(size_t begin, size_t end);
+
+    template <typename Visitor>
+    void search(const Point&, size_t begin, size_t end, Visitor&) const;
 };
 
 
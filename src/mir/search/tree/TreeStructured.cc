@@ -0,0 +1,334 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/search/tree/TreeStructured.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "mir/repres/Coordinates.h"
+#include "mir/repres/Representation.h"
+#include "mir/util/Angles.h"
+#include "mir/util/Atlas.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::search::tree {
+
+
+struct TreeStructured::Rows {
+    struct Row {
+        double latitude;
+        size_t begin;
+        size_t size;
+    };
+
+    std::vector<Row> rows;            ///< by decreasing latitude
+    std::vector<double> longitudes;   ///< in iteration order (increasing within each row)
+    std::vector<size_t> indices;      ///< value index of each point (empty if in iteration order)
+
+    Point point(const Row& row, size_t i) const {
+        // notice the order
+        const atlas::PointLonLat pll(longitudes[i], row.latitude);
+
+        atlas::PointXYZ pxyz;
+        util::Earth::convertSphericalToCartesian(pll, pxyz);
+        return {pxyz.x(), pxyz.y(), pxyz.z()};
+    }
+
+    Payload payload(size_t i) const { return indices.empty() ? i : indices[i]; }
+
+    static std::shared_ptr<const Rows> make(const repres::Representation&);
+};
+
+
+std::shared_ptr<const TreeStructured::Rows> TreeStructured::Rows::make(const repres::Representation& r) {
+    repres::Coordinates coord;
+    r.coordinates(coord);
+
+    const auto N = coord.size();
+    if (N == 0) {
+        return nullptr;
+    }
+
+    const auto& lat = coord.latitudes;
+    const auto& lon = coord.longitudes;
+
+    // rows are consecutive points of the same latitude, of strictly increasing longitudes (less than a turn apart)
+    auto rows = std::make_shared<Rows>();
+    for (size_t i = 0, j = 0; i < N; i = j) {
+        for (j = i + 1; j < N && lat[j] == lat[i]; ++j) {
+            if (!(lon[j - 1] < lon[j])) {
+                return nullptr;
+            }
+        }
+
+        if (!(lon[j - 1] - lon[i] < 360.)) {
+            return nullptr;
+        }
+
+        rows->rows.push_back({lat[i], i, j - i});
+    }
+
+    // too many (short) rows are not worth it (eg. rotated grids)
+    if (rows->rows.size() * rows->rows.size() > 4 * N) {
+        return nullptr;
+    }
+
+    std::sort(rows->rows.begin(), rows->rows.end(),
+              [](const Row& a, const Row& b) { return a.latitude > b.latitude; });
+
+    if (std::adjacent_find(rows->rows.begin(), rows->rows.end(), [](const Row& a, const Row& b) {
+            return a.latitude == b.latitude;
+        }) != rows->rows.end()) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        if (coord.indices[i] != i) {
+            rows->indices = std::move(coord.indices);
+            break;
+        }
+    }
+
+    rows->longitudes = std::move(coord.longitudes);
+    return rows;
+}
+
+
+TreeStructured::TreeStructured(const repres::Representation& r) : Tree(r), rows_(Rows::make(r)) {
+    if (!rows_) {
+        Log::debug() << "TreeStructured: " << r << " is not structured in latitude rows, using a k-d tree" << std::endl;
+        fallback_.reset(TreeFactory::build("memory", r));
+    }
+}
+
+
+TreeStructured::~TreeStructured() = default;
+
+
+void TreeStructured::search(const Point& pt, size_t k, double radius, std::vector<PointValueType>& result) const {
+    // k nearest points (k > 0) or points within radius (k = 0), exactly as a k-d tree over Cartesian coordinates: for
+    // points on the sphere the distance grows with the angle to the query point, which is bounded from below by the
+    // latitude difference (for a row) and grows with the longitude difference (within a row)
+    ASSERT(rows_);
+    const auto& rows = *rows_;
+
+    const auto R2 = pt[0] * pt[0] + pt[1] * pt[1] + pt[2] * pt[2];
+    ASSERT(R2 > 0.);
+
+    const auto R     = std::sqrt(R2);
+    const auto earth = util::Earth::radius();
+    const auto lat   = util::radian_to_degree(std::asin(std::max(-1., std::min(1., pt[2] / R))));
+    const auto lon   = util::radian_to_degree(std::atan2(pt[1], pt[0]));
+
+    struct Found {
+        double distance2;
+        size_t i;
+        const Rows::Row* row;
+        bool operator<(const Found& other) const { return distance2 < other.distance2; }
+    };
+
+    std::vector<Found> found;  // a max-heap for k nearest
+    const auto radius2 = radius * radius;
+
+    auto threshold = [&]() {
+        return k == 0 ? radius2 : found.size() < k ? std::numeric_limits<double>::infinity() : found.front().distance2;
+    };
+
+    auto add = [&](const Found& f) {
+        if (k == 0) {
+            found.emplace_back(f);
+        }
+        else if (found.size() < k) {
+            found.emplace_back(f);
+            std::push_heap(found.begin(), found.end());
+        }
+        else if (f < found.front()) {
+            std::pop_heap(found.begin(), found.end());
+            found.back() = f;
+            std::push_heap(found.begin(), found.end());
+        }
+    };
+
+    auto distance2 = [&](const Rows::Row& row, size_t i) { return Point::distance2(pt, rows.point(row, i)); };
+
+    auto rowDistance2 = [&](const Rows::Row& row) {
+        // lower bound (with a margin for the query latitude)
+        const auto a = std::max(0., util::degree_to_radian(std::abs(row.latitude - lat)) - 1e-9);
+        const auto s = std::sin(a / 2.);
+        return (R - earth) * (R - earth) + 4. * R * earth * s * s;
+    };
+
+    auto searchRow = [&](const Rows::Row& row) {
+        const auto* first = rows.longitudes.data() + row.begin;
+        const auto n      = row.size;
+
+        // walk east and west from the query longitude (wrapping around), taking the nearest point at each step
+        const auto l = util::normalise_longitude(lon, first[0]);
+        size_t e = static_cast<size_t>(std::lower_bound(first, first + n, l) - first) % n;
+        size_t w = (e + n - 1) % n;
+
+        auto de = distance2(row, row.begin + e);
+        auto dw = distance2(row, row.begin + w);
+
+        for (size_t visited = 0; visited < n; ++visited) {
+            const auto east = de <= dw;
+            const auto d2   = east ? de : dw;
+            if (d2 > threshold()) {
+                break;
+            }
+
+            if (east) {
+                add({d2, row.begin + e, &row});
+                e  = (e + 1) % n;
+                de = distance2(row, row.begin + e);
+            }
+            else {
+                add({d2, row.begin + w, &row});
+                w  = (w + n - 1) % n;
+                dw = distance2(row, row.begin + w);
+            }
+        }
+    };
+
+    // walk north and south from the query latitude, taking the nearest row at each step
+    auto south = std::partition_point(rows.rows.begin(), rows.rows.end(),
+                                      [=](const Rows::Row& row) { return row.latitude > lat; });
+
+    size_t s = static_cast<size_t>(south - rows.rows.begin());
+    size_t n = s;
+
+    while (n > 0 || s < rows.rows.size()) {
+        const auto dn    = n > 0 ? rowDistance2(rows.rows[n - 1]) : std::numeric_limits<double>::infinity();
+        const auto ds    = s < rows.rows.size() ? rowDistance2(rows.rows[s]) : std::numeric_limits<double>::infinity();
+        const auto north = dn < ds;
+        if ((north ? dn : ds) > threshold()) {
+            break;
+        }
+
+        searchRow(rows.rows[north ? --n : s++]);
+    }
+
+    // sort by distance (then value index), as k-d trees do
+    std::sort(found.begin(), found.end(), [&](const Found& a, const Found& b) {
+        return a < b || (!(b < a) && rows.payload(a.i) < rows.payload(b.i));
+    });
+
+    result.clear();
+    result.reserve(found.size());
+    for (const auto& f : found) {
+        result.emplace_back(rows.point(*f.row, f.i), rows.payload(f.i));
+    }
+}
+
+
+void TreeStructured::build(std::vector<PointValueType>& v) {
+    ASSERT(fallback_);
+    fallback_->build(v);
+}
+
+
+void TreeStructured::insert(const PointValueType& pt) {
+    ASSERT(fallback_);
+    fallback_->insert(pt);
+}
+
+
+void TreeStructured::statsPrint(std::ostream& out, bool pretty) {
+    if (fallback_) {
+        fallback_->statsPrint(out, pretty);
+    }
+}
+
+
+void TreeStructured::statsReset() {
+    if (fallback_) {
+        fallback_->statsReset();
+    }
+}
+
+
+Tree::PointValueType TreeStructured::nearestNeighbour(const Tree::Point& pt) const {
+    if (fallback_) {
+        return fallback_->nearestNeighbour(pt);
+    }
+
+    std::vector<PointValueType> result;
+    search(pt, 1, 0., result);
+    ASSERT(result.size() == 1);
+    return result.front();
+}
+
+
+void TreeStructured::kNearestNeighbours(const Tree::Point& pt, size_t k, std::vector<PointValueType>& result) const {
+    if (fallback_) {
+        fallback_->kNearestNeighbours(pt, k, result);
+        return;
+    }
+
+    if (k == 0) {
+        result.clear();
+        return;
+    }
+
+    search(pt, k, 0., result);
+}
+
+
+void TreeStructured::findInSphere(const Tree::Point& pt, double radius, std::vector<PointValueType>& result) const {
+    if (fallback_) {
+        fallback_->findInSphere(pt, radius, result);
+        return;
+    }
+
+    search(pt, 0, radius, result);
+}
+
+
+bool TreeStructured::reentrant() const {
+    // queries do not modify the rows
+    return !fallback_ || fallback_->reentrant();
+}
+
+
+bool TreeStructured::ready() const {
+    return !fallback_ || fallback_->ready();
+}
+
+
+void TreeStructured::commit() {
+    if (fallback_) {
+        fallback_->commit();
+    }
+}
+
+
+void TreeStructured::print(std::ostream& out) const {
+    out << "TreeStructured[";
+    if (fallback_) {
+        out << "fallback=" << *fallback_;
+    }
+    else {
+        out << "rows=" << rows_->rows.size() << ",points=" << rows_->longitudes.size();
+    }
+    out << "]";
+}
+
+
+static const TreeBuilder<TreeStructured> builder("structured");
+
+
+}  // namespace mir::search::tree
@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "mir/search/Tree.h"
+
+
+namespace mir::search::tree {
+
+
+/**
+ * Point search exploiting rows of constant latitude (such as Gaussian, regular and reduced lat/lon grids), requiring no
+ * tree build: rows are found by binary search on latitude and points by binary search on longitude, then searched
+ * outwards (both are bounded by distance). Representations without such structure (or rotated) use an in-memory k-d
+ * tree instead.
+ */
+class TreeStructured : public Tree {
+    struct Rows;
+
+    std::shared_ptr<const Rows> rows_;
+    std::unique_ptr<Tree> fallback_;
+
+    void search(const Point&, size_t k, double radius, std::vector<PointValueType>&) const;
+
+protected:
+    void build(std::vector<PointValueType>&) override;
+
+    void insert(const PointValueType&) override;
+
+    void statsPrint(std::ostream&, bool pretty) override;
+
+    void statsReset() override;
+
+    PointValueType nearestNeighbour(const Tree::Point&) const override;
+
+    void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&) const override;
+
+    void findInSphere(const Point&, double radius, std::vector<PointValueType>&) const override;
+
+    bool reentrant() const override;
+
+    bool ready() const override;
+
+    void commit() override;
+
+    void print(std::ostream&) const override;
+
+public:
+    explicit TreeStructured(const repres::Representation&);
+    ~TreeStructured() override;
+};
+
+
+}  // namespace mir::search::tree
@@ -116,6 +116,29 @@ void grib_get_unique_missing_value(const std::vector<double>& values, double& mi
 }
 
 
+size_t grib_message_length(const void* header, size_t size) {
+    const auto* p = static_cast<const unsigned char*>(header);
+    if (size < 16 || std::memcmp(p, "GRIB", 4) != 0) {
+        return 0;
+    }
+
+    size_t len = 0;
+    if (p[7] == 1) {
+        len = (size_t(p[4]) << 16) | (size_t(p[5]) << 8) | size_t(p[6]);
+        return (len & 0x800000) != 0 ? 0 : len;
+    }
+
+    if (p[7] == 2) {
+        for (size_t i = 8; i < 16; ++i) {
+            len = (len << 8) | p[i];
+        }
+        return len;
+    }
+
+    return 0;
+}
+
+
 grib_info::grib_info() :
     grid{}, packing{}, extra_settings_size_(sizeof(packing.extra_settings) / sizeof(packing.extra_settings[0])) {
     // NOTE low-level initialisation only necessary for C interface
@@ -96,3 +96,8 @@ void grib_reorder(std::vector<double>& values, long scanningMode, size_t Ni, siz
 
 
 void grib_get_unique_missing_value(const std::vector<double>& values, double& missingValue);
+
+
+/// GRIB message length from section 0 (editions 1 and 2, first 16 bytes), 0 if not a GRIB message or if unknown (large
+/// GRIB1 messages encode their length elsewhere)
+size_t grib_message_length(const void* header, size_t size);
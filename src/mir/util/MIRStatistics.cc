@@ -19,11 +19,14 @@
 #include "eckit/log/JSON.h"
 #include "eckit/serialisation/Stream.h"
 
+#include "mir/util/Exceptions.h"
+
 
 namespace mir::util {
 
 
-static const std::vector<std::string> all_caches{"mirBitmap", "mirArea", "mirCoefficient", "mirMatrix", "mirMesh"};
+static const std::vector<std::string> all_caches{"mirBitmap", "mirArea",          "mirCoefficient",
+                                                 "mirMatrix", "mirMatrixCompact", "mirMesh"};
 
 
 static const std::vector<std::pair<std::string, std::string>> all_timings{
@@ -43,7 +46,14 @@ static const std::vector<std::pair<std::string, std::string>> all_timings{
     {"nabla", "Time in nabla calculations"},
     {"save", "Time saving"},
     {"gribEncoding", "Time in GRIB encoding"},
-    {"gribDecoding", "Time in GRIB decoding"}};
+    {"gribDecoding", "Time in GRIB decoding"},
+    {"executor", "Time in executor tasks"},
+    {"executorQueue", "Time in executor queue"},
+    {"executorCapacity", "Time in executor threads"}};
+
+
+/// Stream encoding version, to change with the encoded caches, timings or counters
+static constexpr int stream_version = 2;
 
 
 MIRStatistics::MIRStatistics() {
@@ -59,6 +69,15 @@ MIRStatistics::MIRStatistics() {
 
 
 MIRStatistics::MIRStatistics(eckit::Stream& s) {
+    int version = 0;
+    s >> version;
+    if (version != stream_version) {
+        std::ostringstream msg;
+        msg << "MIRStatistics: unsupported stream version " << version << " (expected " << stream_version << ")";
+        throw exception::SeriousBug(msg.str());
+    }
+
+    // same order as encoded
     for (const auto& c : all_caches) {
         caches_.insert({c, s});
     }
@@ -67,17 +86,29 @@ MIRStatistics::MIRStatistics(eckit::Stream& s) {
         s >> timings_[td.first];
         descriptions_[td.first] = td.second;
     }
+
+    s >> executorMaxQueueDepth_;
 }
 
 
 void MIRStatistics::encode(eckit::Stream& s) const {
-    for (const auto& cache : caches_) {
-        s << cache.second;
+    s << stream_version;
+
+    for (const auto& c : all_caches) {
+        s << caches_.at(c);
     }
 
-    for (const auto& tim : timings_) {
-        s << tim.second;
+    for (const auto& td : all_timings) {
+        s << timings_.at(td.first);
     }
+
+    s << executorMaxQueueDepth_;
+}
+
+
+double MIRStatistics::executorUtilisation() const {
+    const auto capacity = timings_.at("executorCapacity").elapsed_;
+    return capacity > 0. ? timings_.at("executor").elapsed_ / capacity : 0.;
 }
 
 
@@ -94,6 +125,9 @@ void MIRStatistics::json(eckit::JSON& j) const {
         j << tim.first << tim.second.elapsed_;
     }
 
+    j << "executorMaxQueueDepth" << executorMaxQueueDepth_;
+    j << "executorUtilisation" << executorUtilisation();
+
     j.endObject();
 }
 
@@ -107,6 +141,8 @@ MIRStatistics& MIRStatistics::operator+=(const MIRStatistics& other) {
         tim.second += other.timings_.at(tim.first);
     }
 
+    executorQueueDepth(other.executorMaxQueueDepth_);
+
     return *this;
 }
 
@@ -133,6 +169,9 @@ void MIRStatistics::report(std::ostream& out, const char* indent) const {
         auto description = descriptions_.at(tim.first);
         reportTime(out, description.c_str(), tim.second, indent);
     }
+
+    reportCount(out, "Executor maximum queue depth", executorMaxQueueDepth_, indent);
+    reportUnit(out, "Executor utilisation", "%", 100. * executorUtilisation(), indent);
 }
 
 
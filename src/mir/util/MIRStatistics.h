@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iosfwd>
 #include <map>
 
@@ -65,8 +66,8 @@ public:
     // -- Methods
 
     template <typename T>
-    caching::InMemoryCacheUser<T> cacheUser(caching::InMemoryCache<T>& cache) {
-        return {cache, caches_.at(cache.name())};
+    void cacheStatistics(const caching::InMemoryCache<T>& cache) {
+        cache.statistics(caches_.at(cache.name()));
     }
 
     AutoTiming cropTimer() { return timings_.at("crop"); }
@@ -89,6 +90,15 @@ public:
 
     Timing& gribEncodingTiming() { return timings_.at("gribEncoding"); }
     Timing& gribDecodingTiming() { return timings_.at("gribDecoding"); }
+    Timing& executorTiming() { return timings_.at("executor"); }
+    Timing& executorQueueTiming() { return timings_.at("executorQueue"); }
+    Timing& executorCapacityTiming() { return timings_.at("executorCapacity"); }
+
+    void executorQueueDepth(size_t depth) { executorMaxQueueDepth_ = std::max(executorMaxQueueDepth_, depth); }
+    size_t executorMaxQueueDepth() const { return executorMaxQueueDepth_; }
+
+    /// Executor utilisation, time in tasks over threads time available (0 if nothing was executed)
+    double executorUtilisation() const;
 
     void report(std::ostream&, const char* indent = "") const;
     void csvHeader(std::ostream&) const;
@@ -127,6 +137,7 @@ private:
     std::map<std::string, caching::InMemoryCacheStatistics> caches_;
     std::map<std::string, Timing> timings_;
     std::map<std::string, std::string> descriptions_;
+    size_t executorMaxQueueDepth_ = 0;
 
     // -- Methods
     // None
@@ -0,0 +1,99 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/util/Parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+
+#include "mir/param/MIRParametrisation.h"
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::util {
+
+
+size_t parallel_threads(const param::MIRParametrisation& param) {
+    static const long parallelThreads = eckit::Resource<long>("mirParallelThreads;$MIR_PARALLEL_THREADS", 1);
+
+    long threads = parallelThreads;
+    param.get("parallel-threads", threads);
+    ASSERT(threads >= 0);
+
+    // 0 means "as many as the hardware supports"
+    if (threads == 0) {
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    return static_cast<size_t>(threads);
+}
+
+
+std::vector<parallel_range_t> parallel_ranges(size_t size, size_t n) {
+    n = std::max<size_t>(1, std::min(n, size));
+
+    std::vector<parallel_range_t> ranges;
+    ranges.reserve(n);
+
+    // distribute the remainder over the first ranges, so sizes differ by one at most
+    const auto chunk = size / n;
+    const auto extra = size % n;
+
+    for (size_t i = 0, begin = 0; i < n && begin < size; ++i) {
+        auto end = begin + chunk + (i < extra ? 1 : 0);
+        ranges.emplace_back(begin, end);
+        begin = end;
+    }
+
+    return ranges;
+}
+
+
+void parallel_for(const std::vector<parallel_range_t>& ranges, const std::function<void(size_t, size_t, size_t)>& f) {
+    if (ranges.empty()) {
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(ranges.size());
+    auto run = [&](size_t i) {
+        try {
+            f(i, ranges[i].first, ranges[i].second);
+        }
+        catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(ranges.size() - 1);
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        threads.emplace_back(run, i);
+    }
+
+    run(0);
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+
+}  // namespace mir::util
@@ -0,0 +1,45 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+namespace mir::param {
+class MIRParametrisation;
+}  // namespace mir::param
+
+
+namespace mir::util {
+
+
+using parallel_range_t = std::pair<size_t, size_t>;
+
+
+/// Number of threads for parallel regions ('parallel-threads', or $MIR_PARALLEL_THREADS, default 1)
+size_t parallel_threads(const param::MIRParametrisation&);
+
+
+/// Partition [0, size) into at most n contiguous, ordered and non-empty ranges [begin, end)
+std::vector<parallel_range_t> parallel_ranges(size_t size, size_t n);
+
+
+/// Execute f(range index, begin, end) for each range concurrently (one thread per range, first range on the calling
+/// thread), rethrowing the first exception caught once all threads have joined
+void parallel_for(const std::vector<parallel_range_t>&, const std::function<void(size_t, size_t, size_t)>& f);
+
+
+}  // namespace mir::util
@@ -10,15 +10,18 @@
  */
 
 
+#include <algorithm>
 #include <ios>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "eckit/option/CmdArgs.h"
 #include "eckit/option/FactoryOption.h"
 #include "eckit/option/SimpleOption.h"
 
+#include "mir/caching/legendre/LegendreBuilder.h"
 #include "mir/caching/legendre/LegendreLoader.h"
 #include "mir/caching/legendre/SharedMemoryLoader.h"
 #include "mir/param/ConfigurationWrapper.h"
@@ -41,6 +44,12 @@ struct MIRLoadLegendre : MIRTool {
             "unload",
             "Unload file from memory. If file is not loaded, or loader does not employ shmem, does nothing."));
         options_.push_back(new SimpleOption<bool>("wait", "After load/unload, wait for user input before exiting."));
+        options_.push_back(new SimpleOption<bool>(
+            "build", "Build coefficients if absent, arguments are <grid>:<truncation> (for example O1280:1279)."));
+        options_.push_back(new SimpleOption<size_t>("processes", "Number of worker processes for --build (default 1)"));
+        options_.push_back(new SimpleOption<std::string>("atlas-trans-type",
+                                                         "Atlas/Trans spectral transforms type (default 'local')"));
+        options_.push_back(new SimpleOption<bool>("atlas-trans-flt", "Atlas/Trans Fast Legendre Transform"));
         options_.push_back(new FactoryOption<caching::legendre::LegendreLoaderFactory>(
             "legendre-loader", "Select how to load Legendre coefficients in memory"));
     }
@@ -49,7 +58,10 @@ struct MIRLoadLegendre : MIRTool {
 
     void usage(const std::string& tool) const override {
         Log::info() << "\n"
-                    << "Usage: " << tool << " [--load] [--unload] <path>" << std::endl;
+                    << "Usage: " << tool << " [--load] [--unload] <path>"
+                    << "\n"
+                       "       "
+                    << tool << " --build [--processes=N] <grid>:<truncation> [<grid>:<truncation> [...]]" << std::endl;
     }
 
     void execute(const eckit::option::CmdArgs& /*args*/) override;
@@ -82,9 +94,29 @@ void MIRLoadLegendre::execute(const eckit::option::CmdArgs& args) {
     bool load   = false;
     bool unload = false;
     bool wait   = false;
+    bool build  = false;
     param.get("load", load);
     param.get("unload", unload);
     param.get("wait", wait);
+    param.get("build", build);
+
+    if (build) {
+        using caching::legendre::LegendreBuilder;
+
+        std::vector<LegendreBuilder::Request> requests;
+        for (const std::string& arg : args) {
+            requests.push_back(LegendreBuilder::request(arg, param));
+        }
+
+        size_t processes = 1;
+        param.get("processes", processes);
+
+        auto failed = LegendreBuilder::build(requests, std::max<size_t>(processes, 1));
+        if (failed > 0) {
+            throw exception::SeriousBug("MIRLoadLegendre: failed to build " + std::to_string(failed) + " of " +
+                                        std::to_string(requests.size()) + " coefficients");
+        }
+    }
 
     if (load || unload) {
         for (const std::string& path : args) {
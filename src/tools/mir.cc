@@ -10,9 +10,17 @@
  */
 
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "eckit/linalg/LinearAlgebraDense.h"
 #include "eckit/linalg/LinearAlgebraSparse.h"
@@ -29,7 +37,11 @@
 #include "mir/data/Space.h"
 #include "mir/grib/BasicAngle.h"
 #include "mir/grib/Packing.h"
+#include "mir/input/GribFileInput.h"
+#include "mir/input/GribMappedFileInput.h"
+#include "mir/input/GribMemoryInput.h"
 #include "mir/input/MIRInput.h"
+#include "mir/input/MultiDimensionalInput.h"
 #include "mir/key/Area.h"
 #include "mir/key/grid/GridPattern.h"
 #include "mir/key/intgrid/Intgrid.h"
@@ -42,7 +54,9 @@
 #include "mir/method/knn/distance/DistanceWeightingWithLSM.h"
 #include "mir/method/knn/pick/Pick.h"
 #include "mir/method/nonlinear/NonLinear.h"
+#include "mir/output/GribOutput.h"
 #include "mir/output/MIROutput.h"
+#include "mir/output/MultiDimensionalOutput.h"
 #include "mir/param/ConfigurationWrapper.h"
 #include "mir/search/Tree.h"
 #include "mir/stats/Distribution.h"
@@ -50,6 +64,7 @@
 #include "mir/stats/Statistics.h"
 #include "mir/tools/MIRTool.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
 #include "mir/util/SpectralOrder.h"
@@ -57,6 +72,7 @@
 #include "mir/util/Types.h"
 
 #if mir_HAVE_ATLAS
+#include "mir/caching/legendre/LegendreBuilder.h"
 #include "mir/caching/legendre/LegendreLoader.h"
 #include "mir/method/fe/FiniteElement.h"
 #endif
@@ -119,6 +135,8 @@ struct MIR : MIRTool {
 
         options_.push_back(
             new SimpleOption<bool>("interpolation-matrix-free", "Matrix-free interpolation (proxy methods)"));
+        options_.push_back(new SimpleOption<bool>(
+            "interpolation-compose", "Compose consecutive interpolations into one operator (linear methods only)"));
 
 #if mir_HAVE_ATLAS
         options_.push_back(new FactoryOption<method::fe::FiniteElementFactory>("l2-projection-input-method",
@@ -173,6 +191,10 @@ struct MIR : MIRTool {
                                                     "filter edge, must be greater than 'distance' (default 1000.)"));
         options_.push_back(
             new SimpleOption<double>("cressman-model-extension-power", "Cressman Model Extension power (default 1.)"));
+        options_.push_back(new SimpleOption<bool>(
+            "grid-box-rows",
+            "Intersect grid boxes by latitude rows if structured, otherwise by k-d tree search, used by grid-box "
+            "methods (default 1)"));
 
         options_.push_back(new SimpleOption<bool>("caching", "Caching of weights and k-d trees (default 1)"));
         options_.push_back(new FactoryOption<eckit::linalg::LinearAlgebraDense>(
@@ -338,9 +360,20 @@ struct MIR : MIRTool {
             "style", "Select how post-processing options are interpreted"));
         options_.push_back(new FactoryOption<data::SpaceChooser>("vector-space", "Select vector-space"));
         options_.push_back(new SimpleOption<size_t>("precision", "Statistics methods output precision"));
-        options_.push_back(new SimpleOption<std::string>("input", "Input options YAML (lat, lon, etc.)"));
+        options_.push_back(new SimpleOption<std::string>("input", "Input options YAML (lat, lon, mapped, etc.)"));
         options_.push_back(new SimpleOption<std::string>("output", "Output options YAML"));
         options_.push_back(new FactoryOption<action::Executor>("executor", "Select whether threads are used or not"));
+        options_.push_back(new SimpleOption<size_t>(
+            "parallel-threads", "Number of threads for parallel regions, such as matrix assembly (0: all, default 1)"));
+        options_.push_back(new SimpleOption<size_t>(
+            "threads", "Number of fields processed concurrently, output in input order (GRIB file input and GRIB "
+                       "output only, default 1; GRIB encoding by ecCodes is serialised)"));
+        options_.push_back(new SimpleOption<size_t>(
+            "pipeline-depth", "Maximum number of fields read but not yet written (default 2 * threads)"));
+        options_.push_back(new SimpleOption<size_t>(
+            "batch", "Maximum number of consecutive fields of the same parameter and representation (spectral: "
+                     "truncation, gridded: grid and bitmap) processed together, output in input order (GRIB only, "
+                     "default 1)"));
         options_.push_back(new SimpleOption<std::string>("plan", "String containing a plan definition"));
         options_.push_back(new SimpleOption<eckit::PathName>("plan-script", "File containing a plan definition"));
 
@@ -348,9 +381,16 @@ struct MIR : MIRTool {
         options_.push_back(new Separator("Caching"));
         options_.push_back(new FactoryOption<caching::matrix::MatrixLoaderFactory>(
             "matrix-loader", "Select how to load matrices in memory"));
+        options_.push_back(new SimpleOption<std::string>(
+            "matrix-compact", "Compact matrix for linear interpolation: none (default), double or float weights"));
 #if mir_HAVE_ATLAS
         options_.push_back(new FactoryOption<caching::legendre::LegendreLoaderFactory>(
             "legendre-loader", "Select how to load Legendre coefficients in memory"));
+        options_.push_back(new VectorOption<std::string>(
+            "legendre-hint",
+            "Build Legendre coefficients if absent in the background, for upcoming <grid>:<truncation> (for example "
+            "O1280:1279/O640:639)",
+            0));
 #endif
 
 #if mir_HAVE_OMP
@@ -418,6 +458,75 @@ struct MIR : MIRTool {
 
     void only(const api::MIRJob& /*job*/, input::MIRInput& /*input*/, output::MIROutput& /*output*/,
               const std::string& /*what*/, size_t /*paramId*/);
+
+    void pipeline(const api::MIRJob& /*job*/, input::GribMappedFileInput& /*input*/, output::GribOutput& /*output*/,
+                  const std::string& /*what*/, size_t /*threads*/, size_t /*depth*/);
+
+    void batch(const api::MIRJob& /*job*/, input::MIRInput& /*input*/, output::MIROutput& /*output*/,
+               const std::string& /*what*/, size_t /*size*/);
+};
+
+
+/// Collects the encoded messages of one field, for the ordered writer
+class BufferOutput : public output::GribOutput {
+public:
+    struct Message {
+        std::vector<char> data;
+        bool interpolated;
+    };
+
+    std::vector<Message>& messages() { return messages_; }
+
+private:
+    std::vector<Message> messages_;
+
+    void out(const void* message, size_t length, bool interpolated) override {
+        const auto* m = static_cast<const char*>(message);
+        messages_.push_back({{m, m + length}, interpolated});
+    }
+
+    bool sameAs(const MIROutput& other) const override { return this == &other; }
+
+    void print(std::ostream& out) const override { out << "BufferOutput[]"; }
+};
+
+
+/// Forwards one dimension of a batch to the (shared, not owned) output
+class ForwardOutput : public output::MIROutput {
+public:
+    explicit ForwardOutput(output::MIROutput& output) : output_(output) {}
+
+private:
+    output::MIROutput& output_;
+
+    size_t copy(const param::MIRParametrisation& param, context::Context& ctx) override {
+        return output_.copy(param, ctx);
+    }
+
+    size_t save(const param::MIRParametrisation& param, context::Context& ctx) override {
+        return output_.save(param, ctx);
+    }
+
+    size_t set(const param::MIRParametrisation& param, context::Context& ctx) override {
+        return output_.set(param, ctx);
+    }
+
+    bool sameAs(const MIROutput& other) const override { return this == &other; }
+
+    bool sameParametrisation(const param::MIRParametrisation& param1,
+                             const param::MIRParametrisation& param2) const override {
+        return output_.sameParametrisation(param1, param2);
+    }
+
+    bool printParametrisation(std::ostream& out, const param::MIRParametrisation& param) const override {
+        return output_.printParametrisation(out, param);
+    }
+
+    void prepare(const param::MIRParametrisation& param, action::ActionPlan& plan, MIROutput& out) override {
+        output_.prepare(param, plan, out);
+    }
+
+    void print(std::ostream& out) const override { out << "ForwardOutput[" << output_ << "]"; }
 };
 
 
@@ -454,6 +563,17 @@ void MIR::execute(const eckit::option::CmdArgs& args) {
     }
 
 
+#if mir_HAVE_ATLAS
+    std::vector<std::string> hints;
+    if (args.get("legendre-hint", hints)) {
+        using caching::legendre::LegendreBuilder;
+        for (const auto& hint : hints) {
+            LegendreBuilder::hint(LegendreBuilder::request(hint, args_wrap));
+        }
+    }
+#endif
+
+
     std::unique_ptr<output::MIROutput> output(output::MIROutputFactory::build(args(1), args_wrap));
     ASSERT(output);
 
@@ -466,6 +586,35 @@ void MIR::execute(const eckit::option::CmdArgs& args) {
         return;
     }
 
+    size_t threads = 1;
+    if (args.get("threads", threads) && threads > 1) {
+        auto* grib = dynamic_cast<output::GribOutput*>(output.get());
+        if (grib == nullptr || dynamic_cast<input::GribFileInput*>(input.get()) == nullptr) {
+            throw exception::UserError("MIR: --threads requires GRIB file input and GRIB output");
+        }
+
+        size_t depth = 2 * threads;
+        args.get("pipeline-depth", depth);
+
+        input::GribMappedFileInput mapped(args(0));
+        pipeline(job, mapped, *grib, "field", threads, depth);
+        return;
+    }
+
+    size_t size = 1;
+    if (args.get("batch", size) && size > 1) {
+        bool vod2uv = false;
+        bool uv2uv  = false;
+        job.get("vod2uv", vod2uv);
+        job.get("uv2uv", uv2uv);
+        if (vod2uv || uv2uv) {
+            throw exception::UserError("MIR: --batch is not supported with --vod2uv or --uv2uv");
+        }
+
+        batch(job, *input, *output, "field", size);
+        return;
+    }
+
     process(job, *input, *output, "field");
 }
 
@@ -513,6 +662,260 @@ void MIR::only(const api::MIRJob& job, input::MIRInput& input, output::MIROutput
 }
 
 
+void MIR::pipeline(const api::MIRJob& job, input::GribMappedFileInput& input, output::GribOutput& output,
+                   const std::string& what, size_t threads, size_t depth) {
+    trace::Timer timer("Total time");
+    ASSERT(threads > 0);
+    ASSERT(depth > 0);
+
+    Log::debug() << "Using " << threads << " threads, pipeline depth " << depth << std::endl;
+
+    // Shared state: fields (message indices) read but not processed, processed but not written, and in-flight count
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<size_t> queue;
+    std::map<size_t, std::vector<BufferOutput::Message>> done;
+    size_t read     = 0;
+    size_t inflight = 0;
+    bool eof        = false;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = e;
+        }
+        cond.notify_all();
+    };
+
+    // Worker stages, sharing the job (and so the cached matrices), decoding from the mapped input (without copies)
+    std::vector<util::MIRStatistics> statistics(threads);
+    auto worker = [&](size_t t) {
+        try {
+            for (;;) {
+                size_t which = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&] { return !queue.empty() || eof || error; });
+                    if (error || queue.empty()) {
+                        return;
+                    }
+                    which = queue.front();
+                    queue.pop_front();
+                }
+
+                Log::debug() << "============> " << what << ": " << (which + 1) << std::endl;
+
+                size_t length       = 0;
+                const void* message = input.message(which, length);
+
+                input::GribMemoryInput in(message, length);
+                if (in.dimensions() != 1) {
+                    throw exception::UserError("MIR: --threads requires single-dimension GRIB input");
+                }
+
+                BufferOutput out;
+                job.execute(in, out, statistics[t]);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                done.emplace(which, std::move(out.messages()));
+                cond.notify_all();
+            }
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+    };
+
+    // Writer stage, to the configured output preserving input order
+    auto writer = [&]() {
+        try {
+            for (size_t next = 0;; ++next) {
+                std::vector<BufferOutput::Message> messages;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&] { return done.find(next) != done.end() || (eof && next == read) || error; });
+                    if (error || done.find(next) == done.end()) {
+                        break;
+                    }
+
+                    auto j   = done.find(next);
+                    messages = std::move(j->second);
+                    done.erase(j);
+                    --inflight;
+                    cond.notify_all();
+                }
+
+                for (const auto& m : messages) {
+                    output.write(m.data.data(), m.data.size(), m.interpolated);
+                }
+            }
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+    };
+
+    std::vector<std::thread> stages;
+    stages.emplace_back(writer);
+    for (size_t t = 0; t < threads; ++t) {
+        stages.emplace_back(worker, t);
+    }
+
+    // Reader stage (this thread), bounded by the pipeline depth
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (size_t i = 0; i < input.messages(); ++i) {
+            cond.wait(lock, [&] { return inflight < depth || error; });
+            if (error) {
+                break;
+            }
+
+            queue.emplace_back(read++);
+            ++inflight;
+            cond.notify_all();
+        }
+
+        eof = true;
+        cond.notify_all();
+    }
+
+    for (auto& stage : stages) {
+        stage.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    util::MIRStatistics total;
+    for (const auto& s : statistics) {
+        total += s;
+    }
+    total.report(Log::info());
+
+    Log::info() << Log::Pretty(read, what) << " in " << timer.elapsedSeconds()
+                << ", rate: " << double(read) / timer.elapsed() << " " << what << "/s" << std::endl;
+}
+
+
+void MIR::batch(const api::MIRJob& job, input::MIRInput& input, output::MIROutput& output, const std::string& what,
+                size_t size) {
+    trace::Timer timer("Total time");
+    ASSERT(size > 0);
+
+    Log::debug() << "Using batches of up to " << Log::Pretty(size, what) << std::endl;
+
+    util::MIRStatistics statistics;
+
+    // Consecutive fields of the same parameter and representation are processed together (as dimensions of one
+    // field), sharing the plan and the interpolation matrix: spectral fields of the same truncation, or gridded fields
+    // of the same grid definition and bitmap (missing values pattern); other fields are processed one at a time
+    auto key = [](input::MIRInput& input) {
+        const auto& param = input.parametrisation();
+
+        std::string gridType;
+        long paramId = 0;
+        if (!param.get("gridType", gridType) || !param.get("paramId", paramId)) {
+            return std::string();
+        }
+
+        if (gridType == "sh") {
+            long truncation = 0;
+            if (!param.get("truncation", truncation)) {
+                return std::string();
+            }
+            return std::to_string(paramId) + "/T" + std::to_string(truncation);
+        }
+
+        auto* h = input.gribHandle();
+        ASSERT(h != nullptr);
+
+        auto md5 = [h](const char* name) {
+            char buffer[64];
+            size_t size = sizeof(buffer);
+            return codes_get_string(h, name, buffer, &size) == CODES_SUCCESS ? std::string(buffer) : std::string();
+        };
+
+        long edition       = 0;
+        long bitmapPresent = 0;
+        GRIB_CALL(codes_get_long(h, "edition", &edition));
+        GRIB_CALL(codes_get_long(h, "bitmapPresent", &bitmapPresent));
+
+        auto grid   = md5("md5GridSection");
+        auto bitmap = bitmapPresent == 0 ? std::string("none") : md5(edition == 1 ? "md5Section3" : "md5Section6");
+        if (grid.empty() || bitmap.empty()) {
+            return std::string();
+        }
+
+        return std::to_string(paramId) + "/" + gridType + "/" + grid + "/" + bitmap;
+    };
+
+    std::vector<std::vector<char>> messages;
+    std::string last;
+    size_t i       = 0;
+    size_t batches = 0;
+
+    auto flush = [&]() {
+        if (messages.empty()) {
+            return;
+        }
+
+        Log::debug() << "============> " << what << ": " << (i - messages.size() + 1) << "-" << i << std::endl;
+
+        if (messages.size() == 1) {
+            input::GribMemoryInput in(messages.front().data(), messages.front().size());
+            job.execute(in, output, statistics);
+        }
+        else {
+            // outputs are written per dimension, in input order
+            input::MultiDimensionalInput in;
+            output::MultiDimensionalOutput out;
+            for (const auto& message : messages) {
+                in.append(new input::GribMemoryInput(message.data(), message.size()));
+                out.appendDimensionalOutput(new ForwardOutput(output));
+            }
+            job.execute(in, out, statistics);
+        }
+
+        messages.clear();
+        ++batches;
+    };
+
+    while (input.next()) {
+        if (input.dimensions() != 1 || input.gribHandle() == nullptr) {
+            throw exception::UserError("MIR: --batch requires single-dimension GRIB input");
+        }
+
+        auto k = key(input);
+        if (k.empty() || k != last || messages.size() >= size) {
+            flush();
+        }
+        last = k;
+
+        const void* message = nullptr;
+        size_t length       = 0;
+        GRIB_CALL(codes_get_message(input.gribHandle(), &message, &length));
+
+        const auto* m = static_cast<const char*>(message);
+        messages.emplace_back(m, m + length);
+        ++i;
+
+        if (k.empty()) {
+            flush();
+        }
+    }
+
+    flush();
+
+    statistics.report(Log::info());
+
+    Log::info() << Log::Pretty(i, what) << " (" << Log::Pretty(batches, {"batch", "batches"}) << ") in "
+                << timer.elapsedSeconds() << ", rate: " << double(i) / timer.elapsed() << " " << what << "/s"
+                << std::endl;
+}
+
+
 }  // namespace tools
 }  // namespace mir
 
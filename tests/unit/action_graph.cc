@@ -10,19 +10,33 @@
  */
 
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
-
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/io/ResizableBuffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
 #include "eckit/testing/Test.h"
 
+#include "mir/action/context/Context.h"
 #include "mir/action/misc/AreaCropper.h"
 #include "mir/action/plan/Action.h"
 #include "mir/action/plan/ActionGraph.h"
 #include "mir/action/plan/ActionNode.h"
 #include "mir/action/plan/ActionPlan.h"
+#include "mir/action/plan/Executor.h"
 #include "mir/api/MIRWatcher.h"
+#include "mir/input/EmptyInput.h"
 #include "mir/param/DefaultParametrisation.h"
 #include "mir/param/RuntimeParametrisation.h"
+#include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
 
 // define EXPECTV(a) log << "\tEXPECT(" << #a <<")" << std::endl; EXPECT(a)
 
@@ -106,6 +120,130 @@ CASE("ActionGraph") {
 }
 
 
+/// Action recording its execution (optionally failing)
+struct TestAction : action::Action {
+    TestAction(const param::MIRParametrisation& param, const std::string& id, std::vector<std::string>& executed,
+               std::mutex& mutex, bool fail = false) :
+        Action(param), id_(id), executed_(executed), mutex_(mutex), fail_(fail) {}
+
+    bool sameAs(const Action& other) const override {
+        const auto* o = dynamic_cast<const TestAction*>(&other);
+        return (o != nullptr) && id_ == o->id_;
+    }
+
+    const char* name() const override { return "TestAction"; }
+
+private:
+    void execute(context::Context& /*unused*/) const override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        executed_.push_back(id_);
+
+        if (fail_) {
+            throw exception::UserError("TestAction: " + id_ + " failed");
+        }
+    }
+
+    void print(std::ostream& out) const override { out << "TestAction[" << id_ << "]"; }
+
+    const std::string id_;
+    std::vector<std::string>& executed_;
+    std::mutex& mutex_;
+    const bool fail_;
+};
+
+
+CASE("ThreadExecutor") {
+    param::DefaultParametrisation empty;
+
+    param::RuntimeParametrisation param(empty);
+    param.set("executor", "thread");
+    param.set("executor.threads", size_t(4));
+
+    const auto& executor = action::Executor::lookup(param);
+
+    std::vector<std::string> executed;
+    std::mutex mutex;
+
+    // plans sharing their first actions (a graph of nested nodes), the last action of each plan depends on all previous
+    const std::vector<std::vector<std::string>> paths{
+        {"a", "a1"}, {"a", "a2"}, {"a", "a3", "a31"}, {"b", "b1"}, {"b", "b2", "b21"}, {"b", "b2", "b22"}};
+
+    auto position = [&executed](const std::string& id) {
+        return size_t(std::find(executed.begin(), executed.end(), id) - executed.begin());
+    };
+
+    auto run = [&](const std::string& failing) {
+        std::vector<std::unique_ptr<action::ActionPlan>> plans;
+        action::ActionGraph graph;
+        for (const auto& path : paths) {
+            plans.emplace_back(new action::ActionPlan(empty));
+            for (const auto& id : path) {
+                plans.back()->add(new TestAction(empty, id, executed, mutex, id == failing));
+            }
+            graph.add(*plans.back(), nullptr);
+        }
+
+        executed.clear();
+
+        input::EmptyInput input;
+        util::MIRStatistics statistics;
+        context::Context ctx(input, statistics);
+
+        graph.execute(ctx, executor);
+        executor.wait();
+
+        return statistics;
+    };
+
+
+    SECTION("nested scheduling") {
+        auto statistics = run("");
+
+        // each node executed once, after its parent
+        EXPECT(executed.size() == 10);
+        for (const auto& path : paths) {
+            for (size_t i = 1; i < path.size(); ++i) {
+                EXPECT(position(path[i - 1]) < position(path[i]));
+                EXPECT(position(path[i]) < executed.size());
+            }
+        }
+
+        // statistics, and their stream encoding
+        Log::info() << "maximum queue depth: " << statistics.executorMaxQueueDepth()
+                    << ", utilisation: " << statistics.executorUtilisation() << std::endl;
+        EXPECT(statistics.executorTiming().updates_ == 10);
+        EXPECT(statistics.executorMaxQueueDepth() > 0);
+        EXPECT(0. < statistics.executorUtilisation() && statistics.executorUtilisation() <= 1.);
+
+        eckit::ResizableBuffer buffer(1024);
+        eckit::ResizableMemoryStream out(buffer);
+        out << statistics;
+
+        eckit::MemoryStream in(buffer.data(), size_t(out.position()));
+        util::MIRStatistics decoded(in);
+        EXPECT(decoded.executorMaxQueueDepth() == statistics.executorMaxQueueDepth());
+        EXPECT(decoded.executorTiming().updates_ == statistics.executorTiming().updates_);
+    }
+
+
+    SECTION("error propagation") {
+        EXPECT_THROWS_AS(run("b2"), exception::UserError);
+
+        // the failing node's children are not executed, all others are
+        EXPECT(executed.size() == 8);
+        EXPECT(position("b2") < executed.size());
+        EXPECT(position("b21") == executed.size());
+        EXPECT(position("b22") == executed.size());
+
+        // executor is usable after an error
+        run("");
+        EXPECT(executed.size() == 10);
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
@@ -0,0 +1,227 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "eckit/linalg/LinearAlgebraSparse.h"
+#include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
+
+#include "mir/api/MIRJob.h"
+#include "mir/input/RawInput.h"
+#include "mir/method/CompactWeightMatrix.h"
+#include "mir/method/WeightMatrix.h"
+#include "mir/output/ResizableOutput.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::tests::unit {
+
+
+using method::CompactWeightMatrix;
+using method::WeightMatrix;
+using Matrix = WeightMatrix::Matrix;
+
+
+static WeightMatrix matrix(WeightMatrix::Size rows, WeightMatrix::Size cols,
+                           const std::vector<WeightMatrix::Triplet>& triplets) {
+    WeightMatrix W(rows, cols);
+    W.setFromTriplets(triplets);
+    return W;
+}
+
+
+/// Columns of distinct, non-trivial values
+static Matrix field(Matrix::Size rows, Matrix::Size cols) {
+    Matrix x(rows, cols);
+    for (Matrix::Size i = 0; i < rows * cols; ++i) {
+        x.data()[i] = 1. + std::sin(double(i + 1));
+    }
+    return x;
+}
+
+
+/// Compare y = C x with the reference y = W x (sparse backend), to a relative tolerance of max |x|
+static bool same_as_reference(const WeightMatrix& W, const CompactWeightMatrix& C, double eps) {
+    const auto x = field(W.cols(), 3);
+
+    Matrix a(W.rows(), x.cols());
+    Matrix b(W.rows(), x.cols());
+    eckit::linalg::LinearAlgebraSparse::backend().spmm(W, x, a);
+    C.multiply(x, b);
+
+    double scale = 0.;
+    for (Matrix::Size i = 0; i < x.size(); ++i) {
+        scale = std::max(scale, std::abs(x.data()[i]));
+    }
+
+    for (Matrix::Size i = 0; i < a.size(); ++i) {
+        if (!eckit::types::is_approximately_equal(a.data()[i], b.data()[i], eps * scale)) {
+            Log::info() << "CompactWeightMatrix: index " << i << ": " << b.data()[i] << " != " << a.data()[i]
+                        << " (reference)" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+CASE("CompactWeightMatrix") {
+    // 5x4, with an empty row (2)
+    const auto W = matrix(5, 4,
+                          {{0, 0, 0.25},
+                           {0, 1, 0.75},
+                           {1, 2, 1.},
+                           {3, 0, 0.2},
+                           {3, 1, 0.3},
+                           {3, 3, 0.5},
+                           {4, 2, 0.9},
+                           {4, 3, 0.1}});
+
+    // 4x4 gather (at most one unit weight per row), with an empty row (1)
+    const auto G = matrix(4, 4, {{0, 1, 1.}, {2, 3, 1.}, {3, 0, 1.}});
+
+
+    SECTION("compactable") {
+        EXPECT(CompactWeightMatrix::compactable(W));
+        EXPECT(CompactWeightMatrix::compactable(G));
+
+        // indices must fit (strictly) in 32 bits
+        constexpr auto max = WeightMatrix::Size(std::numeric_limits<CompactWeightMatrix::Index>::max());
+        EXPECT(CompactWeightMatrix::compactable(WeightMatrix(1, max - 1)));
+        EXPECT(!CompactWeightMatrix::compactable(WeightMatrix(1, max)));
+
+        EXPECT(!CompactWeightMatrix::gatherable(W));
+        EXPECT(CompactWeightMatrix::gatherable(G));
+
+        // a single non-unit weight is not a gather
+        EXPECT(!CompactWeightMatrix::gatherable(matrix(2, 2, {{0, 0, 0.5}})));
+    }
+
+
+    SECTION("multiply (double)") {
+        CompactWeightMatrix C(W, false);
+        Log::info() << C << std::endl;
+
+        EXPECT(!C.gather());
+        EXPECT(!C.singlePrecision());
+        EXPECT(C.rows() == W.rows() && C.cols() == W.cols() && C.nonZeros() == W.nonZeros());
+        EXPECT(same_as_reference(W, C, 1e-14));
+    }
+
+
+    SECTION("multiply (float)") {
+        CompactWeightMatrix C(W, true);
+        Log::info() << C << std::endl;
+
+        EXPECT(!C.gather());
+        EXPECT(C.singlePrecision());
+        EXPECT(same_as_reference(W, C, 1e-7));
+    }
+
+
+    SECTION("multiply (gather)") {
+        for (bool singlePrecision : {false, true}) {
+            CompactWeightMatrix C(G, singlePrecision);
+            Log::info() << C << std::endl;
+
+            // exact, irrespective of precision
+            EXPECT(C.gather());
+            EXPECT(same_as_reference(G, C, 0.));
+        }
+    }
+
+
+    SECTION("emptyRows") {
+        EXPECT(CompactWeightMatrix(W, false).emptyRows() == std::vector<size_t>{2});
+        EXPECT(CompactWeightMatrix(W, true).emptyRows() == std::vector<size_t>{2});
+        EXPECT(CompactWeightMatrix(G, false).emptyRows() == std::vector<size_t>{1});
+    }
+}
+
+
+CASE("CompactWeightMatrix (gather, non-linear treatments)") {
+    // input O4-like reduced_gg, with missing values
+    constexpr double missingValue = 9999.;
+
+    param::SimpleParametrisation meta;
+    meta.set("gridded", true);
+    meta.set("gridType", "reduced_gg");
+    meta.set("north", 90.);
+    meta.set("west", 0.);
+    meta.set("south", -90.);
+    meta.set("east", 360.);
+    meta.set("N", 4);
+    meta.set("pl", std::vector<long>{20, 24, 28, 32, 32, 28, 24, 20});
+    meta.set("missing_value", missingValue);
+
+    std::vector<double> values(208 /*sum(pl)*/);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = i % 7 == 0 ? missingValue : double(i);
+    }
+
+
+    // nearest neighbour within a radius (unit weights, rows without neighbours are empty)
+    auto interpolate = [&](const std::string& nonLinear, bool gather) {
+        input::RawInput input(values.data(), values.size(), meta);
+
+        param::SimpleParametrisation result_meta;
+        std::vector<double> result;
+        output::ResizableOutput output(result, result_meta);
+
+        api::MIRJob job;
+        job.set("grid", std::vector<double>{5., 5.});
+        job.set("interpolation", "k-nearest");
+        job.set("nearest-method", "distance");
+        job.set("distance", 1000e3);
+        job.set("distance-weighting", "nearest-neighbour");
+        job.set("non-linear", nonLinear);
+        job.set("matrix-gather", gather);
+        job.set("caching", false);
+
+        job.execute(input, output);
+        return result;
+    };
+
+
+    for (const std::string& nonLinear :
+         {"missing-if-all-missing", "missing-if-any-missing", "missing-if-heaviest-missing", "heaviest", "no"}) {
+        Log::info() << "non-linear=" << nonLinear << std::endl;
+
+        const auto reference = interpolate(nonLinear, false);
+        const auto result    = interpolate(nonLinear, true);
+
+        EXPECT(!result.empty());
+        EXPECT(result == reference);
+
+        size_t missing = 0;
+        for (auto v : result) {
+            missing += v == missingValue ? 1 : 0;
+        }
+
+        Log::info() << nonLinear << ": " << missing << " missing values of " << result.size() << std::endl;
+        EXPECT(0 < missing && missing < result.size());
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
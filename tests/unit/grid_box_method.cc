@@ -10,8 +10,17 @@
  */
 
 
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
 
+#include "mir/action/context/Context.h"
+#include "mir/key/grid/Grid.h"
+#include "mir/method/MethodWeighted.h"
+#include "mir/param/DefaultParametrisation.h"
 #include "mir/param/SimpleParametrisation.h"
 #include "mir/repres/gauss/reduced/ReducedFromPL.h"
 #include "mir/repres/gauss/regular/RegularGG.h"
@@ -21,6 +30,7 @@
 #include "mir/util/Domain.h"
 #include "mir/util/GridBox.h"
 #include "mir/util/Increments.h"
+#include "mir/util/Log.h"
 #include "mir/util/Types.h"
 
 // define EXPECTV(a) log << "\tEXPECT(" << #a <<")" << std::endl; EXPECT(a)
@@ -156,6 +166,69 @@ CASE("grid boxes: West-East periodicity") {
 }
 
 
+CASE("grid box intersections: latitude rows and k-d tree") {
+    struct Parametrisation : param::DefaultParametrisation {
+        explicit Parametrisation(bool rows) {
+            set("grid-box-rows", rows);
+            set("caching", false);
+        }
+        const MIRParametrisation& userParametrisation() const override { return *this; }
+        const MIRParametrisation& fieldParametrisation() const override { return *this; }
+    };
+
+    auto matrix = [](bool rows, const repres::Representation& in, const repres::Representation& out) {
+        const Parametrisation param(rows);
+        std::unique_ptr<method::Method> method(method::MethodFactory::build("grid-box-average", param));
+
+        auto* m = dynamic_cast<method::MethodWeighted*>(method.get());
+        ASSERT(m != nullptr);
+
+        context::Context ctx;
+        return m->getMatrix(ctx, in, out);
+    };
+
+    // row weights by column
+    auto row = [](const method::WeightMatrix& W, method::WeightMatrix::Size r) {
+        std::map<method::WeightMatrix::Size, double> weights;
+        for (auto it = W.begin(r); it != W.end(r); ++it) {
+            weights[it.col()] = *it;
+        }
+        return weights;
+    };
+
+    for (const auto& name : {"O32", "F32"}) {
+        repres::RepresentationHandle in(key::grid::Grid::lookup(name).representation());
+
+        for (double inc : {5., 1.5}) {
+            repres::RepresentationHandle out(new repres::latlon::RegularLL(util::Increments{inc, inc}));
+            Log::info() << "grid boxes: " << name << " > " << inc << "/" << inc << std::endl;
+
+            auto A = matrix(true, *in, *out);
+            auto B = matrix(false, *in, *out);
+
+            EXPECT(A->rows() == B->rows());
+            EXPECT(A->cols() == B->cols());
+
+            for (method::WeightMatrix::Size r = 0; r < A->rows(); ++r) {
+                auto a = row(*A, r);
+                auto b = row(*B, r);
+                EXPECT(a.empty() == b.empty());
+
+                // same weights, up to intersections of negligible area
+                for (const auto& [c, w] : a) {
+                    auto j = b.find(c);
+                    EXPECT(eckit::types::is_approximately_equal(w, j == b.end() ? 0. : j->second, 1e-9));
+                }
+                for (const auto& [c, w] : b) {
+                    auto j = a.find(c);
+                    EXPECT(eckit::types::is_approximately_equal(w, j == a.end() ? 0. : j->second, 1e-9));
+                }
+            }
+        }
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
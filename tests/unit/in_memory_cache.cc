@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "mir/caching/InMemoryCache.h"
+
+
+namespace mir::tests::unit {
+
+
+using caching::InMemoryCacheUsage;
+
+
+CASE("InMemoryCache") {
+    caching::InMemoryCache<int> cache("test", 2, 0, "$MIR_TEST_CACHE_MEMORY_FOOTPRINT");
+    caching::InMemoryCacheStatistics statistics;
+
+    {
+        // "a" and "c" are in use, so "b" is purged on insertion of "c" (over capacity)
+        auto a = cache.insert("a", new int(1));
+        EXPECT(a && *a == 1);
+
+        cache.insert("b", new int(2));
+        auto c = cache.insert("c", new int(3));
+
+        EXPECT(!cache.find("d"));
+        EXPECT(!cache.find("b"));
+        EXPECT(*cache.find("c") == 3);
+
+        // "a" is the least recently used entry, but it is in use: nothing else can be evicted
+        cache.reserve(InMemoryCacheUsage(size_t(1), size_t(0)));
+        EXPECT(*cache.find("a") == 1);
+        EXPECT(*cache.find("c") == 3);
+
+        // an entry erased while in use is destroyed with its last handle
+        cache.erase("c");
+        EXPECT(!cache.find("c"));
+        EXPECT(*c == 3);
+    }
+
+    // "a" is no longer in use
+    cache.reserve(InMemoryCacheUsage(size_t(2), size_t(0)));
+    EXPECT(!cache.find("a"));
+
+    cache.statistics(statistics);
+
+    EXPECT(statistics.insertions_ == 3);
+    EXPECT(statistics.evictions_ == 2);
+    EXPECT(statistics.hits_ == 3);
+    EXPECT(statistics.misses_ == 4);
+}
+
+
+CASE("InMemoryCache (concurrent)") {
+    caching::InMemoryCache<std::string> cache("test-concurrent", 8, 0, "$MIR_TEST_CACHE_CONCURRENT_MEMORY_FOOTPRINT");
+
+    constexpr size_t THREADS = 8;
+    constexpr size_t KEYS    = 32;
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> errors(THREADS, 0);
+
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&cache, &errors, t]() {
+            for (size_t i = 0; i < 1000; ++i) {
+                // keys are inserted by their "owner" thread only (insertion of an existing key is not supported)
+                auto key = std::to_string((i * 7 + t) % KEYS);
+                auto h   = cache.find(key);
+                if (!h && std::stoul(key) % THREADS == t) {
+                    h = cache.insert(key, new std::string(key));
+                }
+
+                // entries in use are never destroyed
+                if (h && *h != key) {
+                    errors[t]++;
+                }
+
+                if (i % 100 == 0) {
+                    cache.reserve(InMemoryCacheUsage(size_t(4), size_t(0)));
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (auto e : errors) {
+        EXPECT(e == 0);
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
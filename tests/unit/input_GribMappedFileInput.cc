@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/TmpFile.h"
+#include "eckit/testing/Test.h"
+
+#include "mir/input/GribFileInput.h"
+#include "mir/input/GribMappedFileInput.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::tests::unit {
+
+
+static std::string message(const input::MIRInput& input) {
+    const void* message = nullptr;
+    size_t length       = 0;
+    GRIB_CALL(codes_get_message(input.gribHandle(), &message, &length));
+    return {static_cast<const char*>(message), length};
+}
+
+
+CASE("GribMappedFileInput") {
+    // GRIB1 and GRIB2 messages, with padding in between
+    eckit::TmpFile path;
+    {
+        std::ofstream out(path.asString().c_str(), std::ios::binary);
+        for (const std::string& file : {"MIR-425.grib1", "MIR-351.corrected.grib2", "MIR-583.grib1"}) {
+            std::ifstream in(file.c_str(), std::ios::binary);
+            out << in.rdbuf() << std::string(3, '\0');
+        }
+    }
+
+    std::vector<std::string> reference;
+    for (input::GribFileInput input(path); input.next();) {
+        reference.emplace_back(message(input));
+    }
+    EXPECT(reference.size() == 3);
+
+
+    SECTION("next") {
+        input::GribMappedFileInput input(path);
+        Log::info() << input << std::endl;
+        EXPECT(input.messages() == reference.size());
+
+        for (const auto& ref : reference) {
+            EXPECT(input.next());
+            EXPECT(message(input) == ref);
+        }
+        EXPECT(!input.next());
+    }
+
+
+    SECTION("random access") {
+        input::GribMappedFileInput input(path);
+
+        for (size_t i : {2, 0, 1}) {
+            size_t length   = 0;
+            const auto* msg = static_cast<const char*>(input.message(i, length));
+            EXPECT(std::string(msg, length) == reference[i]);
+
+            EXPECT(input.seek(i));
+            EXPECT(message(input) == reference[i]);
+        }
+
+        EXPECT(input.seek(1));
+        EXPECT(input.next());
+        EXPECT(message(input) == reference[2]);
+
+        EXPECT(!input.seek(reference.size()));
+        EXPECT(!input.next());
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
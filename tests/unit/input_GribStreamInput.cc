@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/TmpFile.h"
+#include "eckit/testing/Test.h"
+
+#include "mir/input/GribFileInput.h"
+#include "mir/input/GribMappedFileInput.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::tests::unit {
+
+
+static std::string message(const input::MIRInput& input) {
+    const void* message = nullptr;
+    size_t length       = 0;
+    GRIB_CALL(codes_get_message(input.gribHandle(), &message, &length));
+    return {static_cast<const char*>(message), length};
+}
+
+
+/// Messages with padding in between
+static void write(const eckit::PathName& path, const std::vector<std::string>& messages) {
+    std::ofstream out(path.asString().c_str(), std::ios::binary);
+    for (const auto& msg : messages) {
+        out << msg << std::string(3, '\0');
+    }
+}
+
+
+CASE("GribStreamInput") {
+    // run with MIR_GRIB_INPUT_READ_AHEAD=N to read messages in a background thread
+    static const auto readAhead = eckit::Resource<size_t>("$MIR_GRIB_INPUT_READ_AHEAD", 0);
+    Log::info() << "MIR_GRIB_INPUT_READ_AHEAD=" << readAhead << std::endl;
+
+    // GRIB1 and GRIB2 messages, with padding in between
+    eckit::TmpFile path;
+    {
+        std::ofstream out(path.asString().c_str(), std::ios::binary);
+        for (const std::string& file : {"MIR-425.grib1", "MIR-351.corrected.grib2", "MIR-583.grib1"}) {
+            std::ifstream in(file.c_str(), std::ios::binary);
+            out << in.rdbuf() << std::string(3, '\0');
+        }
+    }
+
+    std::vector<std::string> reference;
+    for (input::GribMappedFileInput input(path); input.next();) {
+        reference.emplace_back(message(input));
+    }
+    EXPECT(reference.size() >= 3);
+
+
+    SECTION("next") {
+        input::GribFileInput input(path);
+
+        for (const auto& ref : reference) {
+            EXPECT(input.next());
+            EXPECT(message(input) == ref);
+        }
+        EXPECT(!input.next());
+    }
+
+
+    SECTION("skip and step") {
+        for (size_t skip : {0, 1, 2}) {
+            for (size_t step : {1, 2, 3}) {
+                Log::info() << "skip=" << skip << ", step=" << step << std::endl;
+                input::GribFileInput input(path, skip, step);
+
+                for (size_t i = skip; i < reference.size(); i += step) {
+                    EXPECT(input.next());
+                    EXPECT(message(input) == reference[i]);
+                }
+                EXPECT(!input.next());
+            }
+        }
+    }
+
+
+    SECTION("message not ending in 7777") {
+        auto corrupt      = reference;
+        corrupt[1].back() = '0';
+
+        eckit::TmpFile corrupted;
+        write(corrupted, corrupt);
+
+        {
+            // reading
+            input::GribFileInput input(corrupted);
+            EXPECT(input.next());
+            EXPECT(message(input) == reference[0]);
+            EXPECT_THROWS(input.next());
+        }
+
+        {
+            // skipping
+            input::GribFileInput input(corrupted, 1, 1);
+            EXPECT_THROWS(input.next());
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
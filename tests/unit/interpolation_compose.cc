@@ -0,0 +1,119 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
+
+#include "mir/action/context/Context.h"
+#include "mir/action/interpolate/Gridded2RegularLL.h"
+#include "mir/action/misc/AreaCropper.h"
+#include "mir/data/MIRField.h"
+#include "mir/input/RawInput.h"
+#include "mir/param/CombinedParametrisation.h"
+#include "mir/param/DefaultParametrisation.h"
+#include "mir/param/RuntimeParametrisation.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/repres/Representation.h"
+#include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
+
+
+namespace mir::tests::unit {
+
+
+CASE("Composed interpolation (interpolation-compose)") {
+    auto& log = Log::info();
+
+    param::DefaultParametrisation defaults;
+    util::MIRStatistics statistics;
+
+
+    // input O4-like reduced_gg, of smooth values (no missing values)
+    param::SimpleParametrisation meta;
+    meta.set("gridded", true);
+    meta.set("gridType", "reduced_gg");
+    meta.set("north", 90.);
+    meta.set("west", 0.);
+    meta.set("south", -90.);
+    meta.set("east", 360.);
+    meta.set("N", 4);
+    meta.set("pl", std::vector<long>{20, 24, 28, 32, 32, 28, 24, 20});
+
+    std::vector<double> values(208 /*sum(pl)*/);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 280. + 10. * std::sin(0.1 * double(i));
+    }
+
+
+    // interpolate to 10/10 then to 5/5 (optionally cropped), as the fused or as two separate actions
+    auto interpolate = [&](bool compose, bool crop) {
+        input::RawInput input(values.data(), values.size(), meta);
+
+        param::SimpleParametrisation user;
+        user.set("interpolation", "k-nearest");
+        user.set("interpolation-compose", compose);
+        user.set("caching", false);
+
+        param::CombinedParametrisation param(user, input.parametrisation(), defaults);
+        param::RuntimeParametrisation param1(param);
+        param::RuntimeParametrisation param2(param);
+        param::RuntimeParametrisation param3(param);
+        param1.set("grid", "10/10");
+        param2.set("grid", "5/5");
+        param3.set("area", "60/0/-60/180");
+
+        std::unique_ptr<action::Action> first(new action::interpolate::Gridded2RegularLL(param1));
+        std::unique_ptr<action::Action> second(new action::interpolate::Gridded2RegularLL(param2));
+        action::AreaCropper cropper(param3);
+
+        // as ActionPlan::compress
+        EXPECT(first->fuseWithNext(second) == compose);
+        if (crop) {
+            EXPECT((compose ? first : second)->mergeWithNext(cropper));
+        }
+
+        context::Context ctx(input, statistics);
+        first->perform(ctx);
+        if (second) {
+            second->perform(ctx);
+        }
+
+        log << "compose=" << compose << ", crop=" << crop << ": " << *ctx.field().representation() << std::endl;
+        return ctx.field().values(0);
+    };
+
+
+    for (bool crop : {false, true}) {
+        const auto reference = interpolate(false, crop);
+        const auto result    = interpolate(true, crop);
+
+        EXPECT(!result.empty());
+        EXPECT(result.size() == reference.size());
+
+        for (size_t i = 0; i < result.size(); ++i) {
+            // composition differs from two-step interpolation by rounding only
+            EXPECT(eckit::types::is_approximately_equal(result[i], reference[i], 1e-9));
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -11,6 +11,8 @@
 
 
 #include <ios>
+#include <memory>
+#include <vector>
 
 #include "eckit/testing/Test.h"
 #include "eckit/types/Fraction.h"
@@ -18,8 +20,11 @@
 #include "mir/api/mir_config.h"
 #include "mir/iterator/detail/RegularIterator.h"
 #include "mir/key/grid/Grid.h"
+#include "mir/repres/Coordinates.h"
 #include "mir/repres/Representation.h"
 #include "mir/repres/gauss/GaussianIterator.h"
+#include "mir/repres/gauss/regular/RotatedGG.h"
+#include "mir/repres/latlon/RotatedLL.h"
 #include "mir/util/BoundingBox.h"
 #include "mir/util/Increments.h"
 #include "mir/util/Log.h"
@@ -343,6 +348,48 @@ CASE("GaussianIterator") {
     log.precision(old);
 }
 
+CASE("Iterator::coordinates") {
+    const BoundingBox bbox{60, -20, -30, 70};
+    const util::Rotation rotation(-40, 22);
+
+    std::vector<repres::RepresentationHandle> reps{
+        key::grid::Grid::lookup("F48").representation(),
+        key::grid::Grid::lookup("O32").representation(),
+        key::grid::Grid::lookup("1/1").representation(),
+        key::grid::Grid::lookup("2.5/2").representation(),
+        new repres::gauss::regular::RotatedGG(32, rotation),
+        new repres::latlon::RotatedLL(Increments(1, 1), rotation),
+    };
+
+    for (size_t n = reps.size(), i = 0; i < n; ++i) {
+        reps.emplace_back(reps[i]->croppedRepresentation(bbox));
+    }
+
+    // bulk coordinates should match point-by-point iteration exactly
+    for (const repres::Representation* rep : reps) {
+        for (bool rotated : {true, false}) {
+            log << "Test " << *rep << " (" << (rotated ? "rotated" : "unrotated") << ")" << std::endl;
+
+            repres::Coordinates coord;
+            rep->coordinates(coord, rotated);
+            EXPECT(coord.size() == rep->numberOfPoints());
+
+            size_t i = 0;
+            for (std::unique_ptr<repres::Iterator> it(rep->iterator()); it->next(); ++i) {
+                ASSERT(i < coord.size());
+                EXPECT(coord.indices[i] == it->index());
+
+                const PointLatLon p = rotated ? PointLatLon{it->pointRotated()[0], it->pointRotated()[1]}
+                                              : it->pointUnrotated();
+                EXPECT(coord.latitudes[i] == p.lat().value());
+                EXPECT(coord.longitudes[i] == p.lon().value());
+            }
+            EXPECT(i == coord.size());
+        }
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
@@ -0,0 +1,95 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "mir/caching/LegendreCache.h"
+#include "mir/caching/legendre/LegendreBuilder.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/util/Atlas.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::tests::unit {
+
+
+using caching::legendre::LegendreBuilder;
+
+
+/// If the LegendreCache entry exists (looked up without creating it)
+static bool exists(const LegendreBuilder::Request& r) {
+    struct : caching::LegendreCache::CacheContentCreator {
+        bool created = false;
+        void create(const eckit::PathName& /*path*/, caching::LegendreCacheTraits::value_type& /*value*/,
+                    bool& saved) override {
+            created = true;
+            saved   = false;
+        }
+    } creator;
+
+    atlas::trans::LegendreCacheCreator legendre(r.grid, r.truncation, r.options);
+    ASSERT(legendre.supported());
+
+    static caching::LegendreCache cache;
+    int dummy = 0;
+    auto path = cache.getOrCreate(legendre.uid(), creator, dummy);
+
+    Log::info() << r << ": '" << path << "'" << (creator.created ? " (absent)" : "") << std::endl;
+    return !creator.created && path.exists();
+}
+
+
+CASE("LegendreBuilder") {
+    const param::SimpleParametrisation param;  // default spectral transforms options
+
+
+    SECTION("build (in-process and worker processes)") {
+        const std::vector<LegendreBuilder::Request> requests{LegendreBuilder::request("F16:15", param),
+                                                             LegendreBuilder::request("F24:23", param)};
+
+        EXPECT(LegendreBuilder::build({requests.front()}, 1) == 0);
+        EXPECT(exists(requests.front()));
+
+        // present entries are not built again
+        EXPECT(LegendreBuilder::build(requests, 2) == 0);
+        for (const auto& r : requests) {
+            EXPECT(exists(r));
+        }
+    }
+
+
+    SECTION("hint (background)") {
+        auto r = LegendreBuilder::request("F32:31", param);
+
+        LegendreBuilder::hint(r);
+        LegendreBuilder::hint(r);  // once per cache entry
+        LegendreBuilder::wait();
+
+        EXPECT(exists(r));
+    }
+
+
+    SECTION("request") {
+        EXPECT_THROWS_AS(LegendreBuilder::request("F16", param), exception::UserError);
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,160 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
+
+#include "mir/method/WeightMatrix.h"
+#include "mir/method/nonlinear/NonLinear.h"
+#include "mir/method/solver/Multiply.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/util/Log.h"
+#include "mir/util/Types.h"
+
+
+namespace mir::tests::unit {
+
+
+CASE("NonLinear::treatmentRow") {
+    using method::WeightMatrix;
+    using method::nonlinear::NonLinear;
+    using method::nonlinear::NonLinearFactory;
+
+    auto& log = Log::info();
+
+    constexpr double missingValue = 9999.;
+
+    // 4 output x 5 input points, rows with none, some, heaviest and all input values missing
+    const MIRValuesVector values{1., missingValue, 3., missingValue, 5.};
+    const std::vector<WeightMatrix::Triplet> triplets{
+        {0, 0, 0.5}, {0, 2, 0.5}, {1, 0, 0.6}, {1, 1, 0.3}, {1, 4, 0.1},
+        {2, 1, 0.7}, {2, 2, 0.2}, {2, 4, 0.1}, {3, 1, 0.5}, {3, 3, 0.5},
+    };
+
+    WeightMatrix W(4, 5);
+    W.setFromTriplets(triplets);
+
+    param::SimpleParametrisation param;
+    param.set("simulated-missing-value", missingValue);
+
+    for (const std::string& name : {"missing-if-heaviest-missing", "missing-if-all-missing", "missing-if-any-missing",
+                                    "simulated-missing-value", "heaviest", "no"}) {
+        log << "Test " << name << std::endl;
+        std::unique_ptr<const NonLinear> n(NonLinearFactory::build(name, param));
+        EXPECT(n->rowWise());
+
+        // treatment on matrix copy
+        WeightMatrix M(W);
+        WeightMatrix::Matrix A;
+        WeightMatrix::Matrix B;
+        n->treatment(A, M, B, values, missingValue);
+
+        // treatment per row, compared to the above
+        for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
+            std::vector<WeightMatrix::Scalar> weights;
+            std::vector<double> rowValues;
+            for (auto it = W.begin(r); it != W.end(r); ++it) {
+                weights.push_back(*it);
+                rowValues.push_back(values[it.col()]);
+            }
+
+            n->treatmentRow(weights, rowValues, missingValue);
+
+            size_t k = 0;
+            for (auto it = M.begin(r); it != M.end(r); ++it, ++k) {
+                EXPECT(k < weights.size());
+                EXPECT(*it == weights[k]);
+            }
+            EXPECT(k == weights.size());
+        }
+    }
+}
+
+
+CASE("Multiply::solve (row-wise non-linear treatments)") {
+    using method::WeightMatrix;
+    using method::nonlinear::NonLinear;
+    using method::nonlinear::NonLinearFactory;
+
+    auto& log = Log::info();
+
+    constexpr double missingValue = 9999.;
+    constexpr size_t Ni           = 300;
+    constexpr size_t No           = 200;
+    constexpr size_t Nc           = 3;
+
+    // input values with a bitmap, and rows of 1 to 4 weights (some empty)
+    MIRValuesVector values(Ni);
+    for (size_t i = 0; i < Ni; ++i) {
+        values[i] = i % 5 == 0 || i % 7 == 0 ? missingValue : double(i % 11);
+    }
+
+    std::vector<WeightMatrix::Triplet> triplets;
+    for (size_t r = 0; r < No; ++r) {
+        const auto n = r % 5;
+        for (size_t k = 0; k < n; ++k) {
+            triplets.emplace_back(r, (r * 3 + k * 17) % Ni, double(k + 1) / double(n * (n + 1) / 2));
+        }
+    }
+
+    WeightMatrix W(No, Ni);
+    W.setFromTriplets(triplets);
+
+    WeightMatrix::Matrix A(Ni, Nc);
+    for (size_t i = 0; i < Ni; ++i) {
+        for (size_t j = 0; j < Nc; ++j) {
+            A(i, j) = values[i] * double(j + 1);
+        }
+    }
+
+    param::SimpleParametrisation param;
+    param.set("simulated-missing-value", missingValue);
+
+    const method::solver::Multiply multiply(param);
+
+    for (const std::string& name : {"missing-if-heaviest-missing", "missing-if-all-missing", "missing-if-any-missing",
+                                    "simulated-missing-value", "heaviest", "no"}) {
+        std::vector<std::unique_ptr<const NonLinear>> nonLinear;
+        nonLinear.emplace_back(NonLinearFactory::build(name, param));
+
+        // reference: treatment on matrix copy, then multiplication
+        WeightMatrix M(W);
+        WeightMatrix::Matrix reference(No, Nc);
+        nonLinear.front()->treatment(A, M, reference, values, missingValue);
+        multiply.solve(A, M, reference, missingValue);
+
+        for (size_t threads : {1, 4}) {
+            log << "Test " << name << " (threads=" << threads << ")" << std::endl;
+
+            WeightMatrix::Matrix B(No, Nc);
+            multiply.solve(A, W, B, missingValue, values, nonLinear, threads);
+
+            for (size_t r = 0; r < No; ++r) {
+                for (size_t j = 0; j < Nc; ++j) {
+                    EXPECT(eckit::types::is_approximately_equal(B(r, j), reference(r, j), 1e-9));
+                }
+            }
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "mir/api/MIRJob.h"
+#include "mir/input/GribMemoryInput.h"
+#include "mir/output/GribMemoryOutput.h"
+#include "mir/repres/Representation.h"
+#include "mir/repres/latlon/RegularLL.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Increments.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::tests::unit {
+
+
+/// GRIB2 message (regular_ll 1/1, grid_simple) with the given bitsPerValue
+static std::string message(long bitsPerValue) {
+    repres::RepresentationHandle repres(new repres::latlon::RegularLL(util::Increments(1, 1)));
+
+    grib_info info;
+    info.packing.editionNumber = 2;
+    info.packing.packing_type  = CODES_UTIL_PACKING_TYPE_GRID_SIMPLE;
+    info.packing.packing       = CODES_UTIL_PACKING_USE_PROVIDED;
+    info.packing.accuracy      = CODES_UTIL_ACCURACY_USE_PROVIDED_BITS_PER_VALUES;
+    info.packing.bitsPerValue  = bitsPerValue;
+    repres->fillGrib(info);
+
+    std::vector<double> values(repres->numberOfPoints());
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = double(i % 100);
+    }
+
+    grib_handle* sample = codes_grib_handle_new_from_samples(nullptr, "regular_ll_pl_grib2");
+    ASSERT(sample);
+    HandleDeleter sample_destroy(sample);
+
+    int err        = 0;
+    grib_handle* h = codes_grib_util_set_spec(sample, &info.grid, &info.packing, 0, values.data(), values.size(), &err);
+    GRIB_CALL(err);
+    ASSERT(h);
+    HandleDeleter h_destroy(h);
+
+    const void* message = nullptr;
+    size_t length       = 0;
+    GRIB_CALL(codes_get_message(h, &message, &length));
+    return {static_cast<const char*>(message), length};
+}
+
+
+/// bitsPerValue of the output of a sub-area extraction, keeping packing and accuracy from input
+static long output_bitsPerValue(const std::string& msg) {
+    input::GribMemoryInput input(msg.data(), msg.size());
+
+    std::vector<char> buffer(msg.size());
+    output::GribMemoryOutput output(buffer.data(), buffer.size());
+
+    api::MIRJob job;
+    job.set("area", 10., 0., 0., 10.);
+    job.execute(input, output);
+    ASSERT(output.length() > 0);
+
+    grib_handle* h = codes_handle_new_from_message(nullptr, buffer.data(), output.length());
+    ASSERT(h);
+    HandleDeleter h_destroy(h);
+
+    long bitsPerValue = 0;
+    GRIB_CALL(codes_get_long(h, "bitsPerValue", &bitsPerValue));
+    return bitsPerValue;
+}
+
+
+CASE("GribOutput templates (MIR_GRIB_OUTPUT_TEMPLATES)") {
+    // inputs differ only in bitsPerValue, the output template should not be shared (with evictions, as there are more
+    // packings than templates)
+    for (long bits : {8, 16, 8, 16, 12, 8, 16, 12, 12}) {
+        auto result = output_bitsPerValue(message(bits));
+        Log::info() << "input bitsPerValue=" << bits << ", output bitsPerValue=" << result << std::endl;
+        EXPECT(result == bits);
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -10,11 +10,14 @@
  */
 
 
+#include <cmath>
 #include <map>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
 
 #include "mir/api/MIRJob.h"
 #include "mir/grib/Packing.h"
@@ -23,6 +26,7 @@
 #include "mir/param/DefaultParametrisation.h"
 #include "mir/param/SimpleParametrisation.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
 #include "mir/util/Log.h"
 
 
@@ -197,6 +201,65 @@ CASE("Packing") {
 }
 
 
+CASE("Packing::packSimple") {
+    auto* sample = codes_grib_handle_new_from_samples(nullptr, "GRIB2");
+    ASSERT(sample != nullptr);
+    HandleDeleter hs(sample);
+
+    size_t n = 0;
+    GRIB_CALL(codes_get_size(sample, "values", &n));
+    ASSERT(n > 0);
+
+    std::vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = 273.15 + 30. * std::sin(double(i)) + 1e-3 * double(i);
+    }
+
+    auto decode = [](const void* message, size_t length) {
+        auto* h = codes_handle_new_from_message_copy(nullptr, message, length);
+        ASSERT(h != nullptr);
+        HandleDeleter hd(h);
+
+        size_t n = 0;
+        GRIB_CALL(codes_get_size(h, "values", &n));
+        std::vector<double> values(n);
+        GRIB_CALL(codes_get_double_array(h, "values", values.data(), &n));
+        return values;
+    };
+
+    for (long bits : {8, 16, 24}) {
+        for (size_t threads : {1, 3}) {
+            Log::info() << "Packing::packSimple: bitsPerValue=" << bits << ", threads=" << threads << std::endl;
+
+            // reference, packed by ecCodes
+            auto* h = codes_handle_clone(sample);
+            HandleDeleter hd(h);
+            GRIB_CALL(codes_set_long(h, "bitsPerValue", bits));
+            GRIB_CALL(codes_set_double_array(h, "values", values.data(), n));
+
+            const void* message = nullptr;
+            size_t length       = 0;
+            GRIB_CALL(codes_get_message(h, &message, &length));
+            auto reference = decode(message, length);
+
+            // packed by MIR, into a message encoded for a constant field
+            std::vector<double> constant(n, 0.);
+            GRIB_CALL(codes_set_double_array(h, "values", constant.data(), n));
+            GRIB_CALL(codes_get_message(h, &message, &length));
+
+            std::vector<char> packed(static_cast<const char*>(message), static_cast<const char*>(message) + length);
+            EXPECT(grib::Packing::packSimple(packed, bits, values, threads));
+            auto result = decode(packed.data(), packed.size());
+
+            EXPECT(result.size() == n);
+            for (size_t i = 0; i < n; ++i) {
+                EXPECT(eckit::types::is_approximately_equal(result[i], reference[i], 1e-9));
+            }
+        }
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
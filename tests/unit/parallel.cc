@@ -0,0 +1,102 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/util/Parallel.h"
+
+
+namespace mir::tests::unit {
+
+
+CASE("parallel_ranges") {
+    SECTION("contiguous and ordered") {
+        for (size_t size : {0, 1, 7, 10, 1000}) {
+            for (size_t n : {1, 3, 8}) {
+                auto ranges = util::parallel_ranges(size, n);
+                EXPECT(ranges.size() <= std::max<size_t>(1, n));
+
+                size_t begin = 0;
+                for (const auto& r : ranges) {
+                    EXPECT(r.first == begin);
+                    EXPECT(r.first < r.second);
+                    begin = r.second;
+                }
+                EXPECT(begin == size);
+            }
+        }
+    }
+
+    SECTION("balanced") {
+        auto ranges = util::parallel_ranges(10, 3);
+        EXPECT(ranges.size() == 3);
+        EXPECT(ranges[0] == util::parallel_range_t(0, 4));
+        EXPECT(ranges[1] == util::parallel_range_t(4, 7));
+        EXPECT(ranges[2] == util::parallel_range_t(7, 10));
+    }
+}
+
+
+CASE("parallel_for") {
+    SECTION("all ranges visited") {
+        const auto ranges = util::parallel_ranges(1000, 7);
+        std::vector<size_t> visits(1000, 0);
+        std::atomic<size_t> calls{0};
+
+        util::parallel_for(ranges, [&](size_t, size_t begin, size_t end) {
+            ++calls;
+            for (size_t i = begin; i < end; ++i) {
+                visits[i]++;
+            }
+        });
+
+        EXPECT(calls == ranges.size());
+        for (auto v : visits) {
+            EXPECT(v == 1);
+        }
+    }
+
+    SECTION("exceptions are rethrown") {
+        const auto ranges = util::parallel_ranges(10, 4);
+        EXPECT_THROWS_AS(util::parallel_for(ranges,
+                                            [](size_t r, size_t, size_t) {
+                                                if (r == 2) {
+                                                    throw std::runtime_error("parallel_for");
+                                                }
+                                            }),
+                         std::runtime_error);
+    }
+}
+
+
+CASE("parallel_threads") {
+    param::SimpleParametrisation param;
+
+    param.set("parallel-threads", 3);
+    EXPECT(util::parallel_threads(param) == 3);
+
+    param.set("parallel-threads", 0);
+    EXPECT(util::parallel_threads(param) >= 1);
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,194 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "mir/key/grid/Grid.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/repres/Coordinates.h"
+#include "mir/repres/Representation.h"
+#include "mir/repres/gauss/regular/RotatedGG.h"
+#include "mir/search/PointSearch.h"
+#include "mir/util/BoundingBox.h"
+#include "mir/util/Log.h"
+#include "mir/util/Rotation.h"
+
+
+namespace mir::tests::unit {
+
+
+static auto& log = Log::info();
+
+
+CASE("TreeStructured") {
+    const util::BoundingBox bbox{60, -20, -30, 70};
+
+    std::vector<repres::RepresentationHandle> reps{
+        key::grid::Grid::lookup("F48").representation(),
+        key::grid::Grid::lookup("O32").representation(),
+        key::grid::Grid::lookup("1/1").representation(),
+        key::grid::Grid::lookup("2.5/2").representation(),
+        new repres::gauss::regular::RotatedGG(32, util::Rotation(-40, 22)),  // (not structured)
+    };
+
+    for (size_t n = reps.size(), i = 0; i < n; ++i) {
+        reps.emplace_back(reps[i]->croppedRepresentation(bbox));
+    }
+
+    repres::Coordinates targets;
+    repres::RepresentationHandle(key::grid::Grid::lookup("O24").representation())->coordinates(targets);
+    const auto points = targets.points3D();
+
+    auto search = [](const repres::Representation& rep, const std::string& trees) {
+        param::SimpleParametrisation param;
+        param.set("caching", false);
+        param.set("point-search-trees", trees);
+        return std::make_unique<search::PointSearch>(param, rep);
+    };
+
+    // same distances as the k-d tree (points at the same distance might differ)
+    for (const repres::Representation* rep : reps) {
+        log << "Test " << *rep << std::endl;
+
+        auto reference = search(*rep, "memory");
+        auto structured = search(*rep, "structured");
+
+        for (size_t n : {1, 4, 16}) {
+            std::vector<std::vector<search::PointSearch::PointValueType>> a;
+            std::vector<std::vector<search::PointSearch::PointValueType>> b;
+            reference->closestNPoints(points, n, a);
+            structured->closestNPoints(points, n, b);
+
+            for (size_t i = 0; i < points.size(); ++i) {
+                EXPECT(a[i].size() == b[i].size());
+                for (size_t j = 0; j < a[i].size(); ++j) {
+                    EXPECT(search::Tree::Point::distance2(points[i], a[i][j].point()) ==
+                           search::Tree::Point::distance2(points[i], b[i][j].point()));
+                }
+            }
+        }
+
+        for (double radius : {100e3, 500e3}) {
+            std::vector<std::vector<search::PointSearch::PointValueType>> a;
+            std::vector<std::vector<search::PointSearch::PointValueType>> b;
+            reference->closestWithinRadius(points, radius, a);
+            structured->closestWithinRadius(points, radius, b);
+
+            for (size_t i = 0; i < points.size(); ++i) {
+                EXPECT(a[i].size() == b[i].size());
+            }
+        }
+    }
+}
+
+
+CASE("TreeMemory") {
+    repres::RepresentationHandle rep(key::grid::Grid::lookup("O32").representation());
+
+    repres::Coordinates targets;
+    repres::RepresentationHandle(key::grid::Grid::lookup("O24").representation())->coordinates(targets);
+    const auto points = targets.points3D();
+
+    auto search = [&](const std::string& trees) {
+        param::SimpleParametrisation param;
+        param.set("caching", false);
+        param.set("point-search-trees", trees);
+        return std::make_unique<search::PointSearch>(param, *rep);
+    };
+
+    // same distances as the (eckit) mapped k-d tree
+    auto reference = search("mapped-temporary-file");
+    auto memory    = search("memory");
+
+    for (size_t n : {1, 4, 16}) {
+        std::vector<std::vector<search::PointSearch::PointValueType>> a;
+        std::vector<std::vector<search::PointSearch::PointValueType>> b;
+        reference->closestNPoints(points, n, a);
+        memory->closestNPoints(points, n, b);
+
+        for (size_t i = 0; i < points.size(); ++i) {
+            EXPECT(a[i].size() == b[i].size());
+            for (size_t j = 0; j < a[i].size(); ++j) {
+                EXPECT(search::Tree::Point::distance2(points[i], a[i][j].point()) ==
+                       search::Tree::Point::distance2(points[i], b[i][j].point()));
+            }
+        }
+    }
+}
+
+
+CASE("PointSearch (concurrent)") {
+    repres::RepresentationHandle rep(key::grid::Grid::lookup("O32").representation());
+
+    repres::Coordinates targets;
+    repres::RepresentationHandle(key::grid::Grid::lookup("O24").representation())->coordinates(targets);
+    const auto points = targets.points3D();
+
+    auto same = [](const std::vector<search::PointSearch::PointValueType>& a,
+                   const std::vector<search::PointSearch::PointValueType>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t j = 0; j < a.size(); ++j) {
+            if (a[j].payload() != b[j].payload()) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // batched queries (in threads) give the same results as serial, single-point queries
+    for (const std::string& trees : {"memory", "mapped-anonymous-memory", "mapped-temporary-file", "structured"}) {
+        param::SimpleParametrisation param;
+        param.set("caching", false);
+        param.set("point-search-trees", trees);
+        search::PointSearch search(param, *rep);
+
+        log << "Test " << trees << " (concurrent: " << search.concurrent() << ")" << std::endl;
+
+        for (size_t n : {1, 4, 16}) {
+            std::vector<std::vector<search::PointSearch::PointValueType>> batched;
+            search.closestNPoints(points, n, batched, 4);
+            EXPECT(batched.size() == points.size());
+
+            std::vector<search::PointSearch::PointValueType> serial;
+            for (size_t i = 0; i < points.size(); ++i) {
+                search.closestNPoints(points[i], n, serial);
+                EXPECT(same(batched[i], serial));
+            }
+        }
+
+        for (double radius : {100e3, 500e3}) {
+            std::vector<std::vector<search::PointSearch::PointValueType>> batched;
+            search.closestWithinRadius(points, radius, batched, 4);
+            EXPECT(batched.size() == points.size());
+
+            std::vector<search::PointSearch::PointValueType> serial;
+            for (size_t i = 0; i < points.size(); ++i) {
+                search.closestWithinRadius(points[i], radius, serial);
+                EXPECT(same(batched[i], serial));
+            }
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "eckit/filesystem/TmpFile.h"
+#include "eckit/testing/Test.h"
+
+#include "mir/caching/matrix/MatrixLoader.h"
+#include "mir/method/WeightMatrix.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::tests::unit {
+
+
+using method::WeightMatrix;
+
+
+static bool same(const WeightMatrix& a, const WeightMatrix& b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols() || a.nonZeros() != b.nonZeros()) {
+        return false;
+    }
+
+    for (WeightMatrix::Size r = 0; r < a.rows(); ++r) {
+        auto i = a.begin(r);
+        auto j = b.begin(r);
+        for (; i != a.end(r) && j != b.end(r); ++i, ++j) {
+            if (i.col() != j.col() || *i != *j) {
+                return false;
+            }
+        }
+        if (i != a.end(r) || j != b.end(r)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+CASE("WeightMatrix save/load") {
+    // matrix with empty rows
+    std::vector<WeightMatrix::Triplet> triplets;
+    for (size_t r = 0; r < 1000; ++r) {
+        for (size_t k = 0; k < r % 4; ++k) {
+            triplets.emplace_back(r, (r * 7 + k * 131) % 2000, 1. / double(k + 1));
+        }
+    }
+
+    WeightMatrix W(1000, 2000);
+    W.setFromTriplets(triplets);
+
+    eckit::TmpFile path;
+    W.save(path);
+
+
+    SECTION("page-aligned layout") {
+        auto page_size = size_t(::sysconf(_SC_PAGESIZE));
+        auto size      = size_t(path.size());
+
+        Log::info() << "file size: " << size << ", footprint: " << W.footprint() << std::endl;
+        EXPECT(size >= W.footprint());
+        EXPECT(size % page_size == 0);
+    }
+
+
+    SECTION("load") {
+        WeightMatrix M(path);
+        EXPECT(same(W, M));
+    }
+
+
+    SECTION("load (matrix loaders)") {
+        for (const std::string& loader : {"file-io", "mapped-memory"}) {
+            WeightMatrix M(caching::matrix::MatrixLoaderFactory::build(loader, path));
+            Log::info() << "loader: " << loader << std::endl;
+            EXPECT(same(W, M));
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}